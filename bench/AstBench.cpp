@@ -0,0 +1,241 @@
+// Global heap allocations of building, serializing and tearing down the report AST, with the
+// containers on the heap and on a per-report ast::ArenaScope. Only operator new is counted:
+// the rapidjson response allocates with malloc and is the same in both modes.
+//   chrome - the table and UI tree CreateReport builds (rows are streamed, not in the tree)
+//   cells  - rows held as JSONValue cells in the tree, as tables were built before streaming
+// Usage: pending_trades_ast_bench [rows]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+
+namespace {
+    std::atomic<uint64_t> allocations_count{0};
+    std::atomic<uint64_t> allocated_bytes{0};
+
+    // The whole replaceable family goes through these two, so every new has its matching delete.
+    // Kept out of line: with free() inlined into a delete, GCC reports free() on memory from
+    // operator new (-Wmismatched-new-delete) even though both sides are replaced here.
+    [[gnu::noinline]] void* Allocate(const size_t size, const size_t alignment) noexcept {
+        allocations_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (alignment <= alignof(std::max_align_t)) {
+            return std::malloc(size == 0 ? 1 : size);
+        }
+        const size_t rounded = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, rounded);
+    }
+
+    void* AllocateOrThrow(const size_t size, const size_t alignment) {
+        if (void* pointer = Allocate(size, alignment)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    [[gnu::noinline]] void Release(void* pointer) noexcept { std::free(pointer); }
+} // namespace
+
+void* operator new(const size_t size) { return AllocateOrThrow(size, 0); }
+
+void* operator new[](const size_t size) { return AllocateOrThrow(size, 0); }
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, 0);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned overloads
+void* operator new(const size_t size, const std::align_val_t alignment) {
+    return AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment) {
+    return AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(const size_t size,
+                   const std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size,
+                     const std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { Release(pointer); }
+
+void operator delete[](void* pointer) noexcept { Release(pointer); }
+
+void operator delete(void* pointer, size_t) noexcept { Release(pointer); }
+
+void operator delete[](void* pointer, size_t) noexcept { Release(pointer); }
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { Release(pointer); }
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { Release(pointer); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept { Release(pointer); }
+
+void operator delete[](void* pointer, std::align_val_t) noexcept { Release(pointer); }
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { Release(pointer); }
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { Release(pointer); }
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    Release(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    Release(pointer);
+}
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const char* const COLUMN_KEYS[] = {"order", "login", "name", "open_time", "type",
+                                       "symbol", "volume", "open_price", "sl", "tp",
+                                       "storage", "profit", "comment", "currency", "group"};
+
+    struct Measurement {
+        uint64_t allocations = 0;
+        uint64_t bytes       = 0;
+        double   ms          = 0;
+    };
+
+    // Rows held as JSONValue cells, as tables were built before streaming
+    JSONArray BuildRows(const size_t rows_count) {
+        JSONArray rows;
+        rows.reserve(rows_count);
+        for (size_t row = 0; row < rows_count; ++row) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "Account holder %zu", row % 1000);
+
+            JSONArray cells;
+            cells.reserve(std::size(COLUMN_KEYS));
+            cells.emplace_back(static_cast<double>(row));
+            cells.emplace_back(100000.0 + static_cast<double>(row % 1000));
+            cells.emplace_back(name);
+            cells.emplace_back("2023.11.15 13:00:26");
+            cells.emplace_back(JSONStaticString{"Buy Limit"});
+            cells.emplace_back("EURUSD");
+            for (int price = 0; price < 6; ++price) {
+                cells.emplace_back(1.25 * price);
+            }
+            cells.emplace_back("pending order placed through the web terminal");
+            cells.emplace_back("USD");
+            cells.emplace_back("real\\USD-1");
+            rows.emplace_back(std::move(cells));
+        }
+        return rows;
+    }
+
+    JSONObject BuildTableProps(const size_t rows_count) {
+        TableBuilder table_builder("PendingTradesReportTable");
+        table_builder.SetIdColumn("order");
+        table_builder.EnableTotal(true);
+        table_builder.SetTotalDataTitle("TOTAL");
+
+        FilterConfig search_filter;
+        search_filter.type = FilterType::Search;
+
+        double order = 0;
+        for (const char* key : COLUMN_KEYS) {
+            table_builder.AddColumn({key, key, ++order, search_filter});
+        }
+        table_builder.StreamRows([](RowWriter&) {});
+
+        JSONArray totals;
+        for (const char* currency : {"USD", "EUR", "GBP", "JPY", "CHF"}) {
+            totals.emplace_back(JSONObject{{"volume", 1234.5}, {"currency", currency}});
+        }
+        table_builder.SetTotalData(std::move(totals));
+
+        JSONObject table_props = std::move(table_builder).CreateTableProps();
+
+        if (rows_count > 0) {
+            table_props["rows"] = BuildRows(rows_count);
+        }
+
+        return table_props;
+    }
+
+    // One report: build the tree, serialize it, destroy it (and the arena)
+    Measurement Run(const size_t rows_count, const bool use_arena) {
+        rapidjson::Document response;
+        response.SetObject();
+
+        const uint64_t allocations_before = allocations_count.load();
+        const uint64_t bytes_before       = allocated_bytes.load();
+        const auto     start              = Clock::now();
+        {
+            std::optional<ArenaScope> arena;
+            if (use_arena) {
+                arena.emplace();
+            }
+
+            const Node report = Column(nodes(h1({text("Pending Trades Report")}),
+                                             Table({}, BuildTableProps(rows_count))));
+            to_json(report, response, response.GetAllocator());
+        }
+        const auto end = Clock::now();
+
+        return {allocations_count.load() - allocations_before,
+                allocated_bytes.load() - bytes_before,
+                std::chrono::duration<double, std::milli>(end - start).count()};
+    }
+
+    void Report(const char* name, const size_t rows_count, const int repeat) {
+        Measurement heap{0, 0, 1e300};
+        Measurement arena{0, 0, 1e300};
+        for (int run = 0; run < repeat; ++run) {
+            const Measurement heap_run  = Run(rows_count, false);
+            const Measurement arena_run = Run(rows_count, true);
+            heap  = {heap_run.allocations, heap_run.bytes, std::min(heap.ms, heap_run.ms)};
+            arena = {arena_run.allocations, arena_run.bytes, std::min(arena.ms, arena_run.ms)};
+        }
+
+        std::printf("%-8s %-6s %12llu %12.1f %10.2f\n",
+                    name, "heap",
+                    static_cast<unsigned long long>(heap.allocations),
+                    static_cast<double>(heap.bytes) / 1024.0,
+                    heap.ms);
+        std::printf("%-8s %-6s %12llu %12.1f %10.2f\n",
+                    name, "arena",
+                    static_cast<unsigned long long>(arena.allocations),
+                    static_cast<double>(arena.bytes) / 1024.0,
+                    arena.ms);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t rows_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100'000;
+
+    std::printf("rows: %zu\n", rows_count);
+    std::printf("%-8s %-6s %12s %12s %10s\n", "tree", "memory", "allocations", "KiB", "best ms");
+    Report("chrome", 0, 20);
+    Report("cells", rows_count, 5);
+
+    // Footprint of the cells: the values plus everything they allocate, row arrays included
+    const uint64_t  bytes_before = allocated_bytes.load();
+    const JSONArray rows         = BuildRows(rows_count);
+    const uint64_t  rows_bytes   = allocated_bytes.load() - bytes_before;
+    std::printf("\nsizeof(JSONValue): %zu, bytes per cell: %.1f\n",
+                sizeof(JSONValue),
+                static_cast<double>(rows_bytes) /
+                    static_cast<double>(rows.size() * std::size(COLUMN_KEYS)));
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Columnar export round trip: writes the synthetic pending trades through ExportColumnar, maps
+// the file back with ColumnarReader and checks every cell against the source records, then
+// times a full scan of the mapped columns. A truncated copy of the file must be rejected.
+// Usage: pending_trades_columnar_bench [orders]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+#include "SyntheticServer.h"
+#include "report/AccountIndex.h"
+#include "report/ColumnarExport.h"
+#include "report/GroupIndex.h"
+#include "utils/Utils.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(const Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool SameBits(const double lhs, const double rhs) {
+        return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::SyntheticDataConfig config;
+    config.pending_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    config.days          = 7;
+
+    bench::SyntheticServer                server(config);
+    const std::vector<ReportTradeRecord>& trades = server.GetTrades();
+
+    report::GroupIndex group_index;
+    group_index.Build(server.GetGroups());
+
+    std::vector<uint32_t> rows(trades.size());
+    std::iota(rows.begin(), rows.end(), 0);
+
+    report::AccountIndex account_index;
+    account_index.Build(&server, "*", trades, rows);
+
+    // Export
+    rapidjson::Document response;
+    auto                start = Clock::now();
+    report::ExportColumnar(
+        trades, rows, account_index, group_index, response, response.GetAllocator());
+    const double export_ms = ElapsedMs(start);
+
+    const rapidjson::Value& result = response["export"];
+    if (!result.HasMember("file")) {
+        std::fprintf(stderr, "export failed: %s\n", result["error"].GetString());
+        return 1;
+    }
+    const std::string path = result["file"].GetString();
+
+    // Read back
+    report::ColumnarReader reader;
+    start = Clock::now();
+    if (!reader.Open(path)) {
+        std::fprintf(stderr, "%s\n", reader.GetError().c_str());
+        std::filesystem::remove(path);
+        return 1;
+    }
+    const double open_ms = ElapsedMs(start);
+
+    const auto column = [&reader](const char* name) { return reader.FindColumn(name); };
+    const auto* order      = column("order");
+    const auto* login      = column("login");
+    const auto* name       = column("name");
+    const auto* open_time  = column("open_time");
+    const auto* type       = column("type");
+    const auto* symbol     = column("symbol");
+    const auto* volume     = column("volume");
+    const auto* open_price = column("open_price");
+    const auto* profit     = column("profit");
+    const auto* comment    = column("comment");
+    const auto* currency   = column("currency");
+    const auto* group      = column("group");
+
+    size_t mismatches = reader.RowsCount() != rows.size() || reader.ColumnsCount() != 15;
+    for (const auto* header : {order, login, name, open_time, type, symbol, volume, open_price,
+                               profit, comment, currency, group}) {
+        if (!header) {
+            std::fprintf(stderr, "missing column\n");
+            std::filesystem::remove(path);
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < reader.RowsCount() && i < rows.size(); ++i) {
+        const ReportTradeRecord&   trade   = trades[rows[i]];
+        const ReportAccountRecord& account = account_index.Find(trade.login);
+
+        const bool is_same =
+            reader.Int64Values(*order)[i] == trade.order &&
+            reader.Int64Values(*login)[i] == trade.login &&
+            reader.Int64Values(*open_time)[i] == trade.open_time &&
+            reader.String(*name, i) == account.name &&
+            reader.String(*comment, i) == trade.comment &&
+            reader.String(*type, i) == utils::ConvertCmdToString(static_cast<int>(trade.cmd)) &&
+            reader.String(*symbol, i) == trade.symbol &&
+            reader.String(*currency, i) ==
+                group_index.GetCurrency(group_index.GetCurrencyId(account.group)) &&
+            reader.String(*group, i) == account.group &&
+            SameBits(reader.Float64Values(*volume)[i],
+                     utils::TruncateDouble(trade.volume / 100.0, 2)) &&
+            SameBits(reader.Float64Values(*open_price)[i],
+                     utils::TruncateDouble(trade.open_price, 2)) &&
+            SameBits(reader.Float64Values(*profit)[i], utils::TruncateDouble(trade.profit, 2));
+        mismatches += is_same ? 0 : 1;
+    }
+
+    // Analytics-style scan: profit and volume per currency straight from the mapping
+    start = Clock::now();
+    std::vector<double> profit_by_currency(currency->dictionary_size, 0.0);
+    std::vector<double> volume_by_currency(currency->dictionary_size, 0.0);
+    const uint32_t*     codes   = reader.Codes(*currency);
+    const double*       profits = reader.Float64Values(*profit);
+    const double*       volumes = reader.Float64Values(*volume);
+    for (size_t i = 0; i < reader.RowsCount(); ++i) {
+        profit_by_currency[codes[i]] += profits[i];
+        volume_by_currency[codes[i]] += volumes[i];
+    }
+    const double scan_ms = ElapsedMs(start);
+
+    // A truncated file fails validation instead of reading past the mapping
+    const std::string truncated = path + ".truncated";
+    std::filesystem::copy_file(path, truncated, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::resize_file(truncated, std::filesystem::file_size(path) / 2);
+    report::ColumnarReader truncated_reader;
+    const bool             is_truncated_rejected = !truncated_reader.Open(truncated);
+
+    std::printf("orders: %zu, file: %.1f MiB\n",
+                rows.size(),
+                static_cast<double>(result["bytes"].GetUint64()) / (1024.0 * 1024.0));
+    std::printf("%-28s %10.2f\n", "export ms", export_ms);
+    std::printf("%-28s %10.3f\n", "open (mmap + validate) ms", open_ms);
+    std::printf("%-28s %10.2f\n", "scan profit, volume ms", scan_ms);
+    std::printf("%-28s %10zu\n", "mismatches", mismatches);
+    std::printf("%-28s %10s\n", "truncated file rejected", is_truncated_rejected ? "yes" : "NO");
+
+    reader.Close();
+    std::filesystem::remove(truncated);
+    std::filesystem::remove(path);
+
+    return mismatches == 0 && is_truncated_rejected ? 0 : 1;
+}
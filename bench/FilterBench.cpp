@@ -0,0 +1,91 @@
+// Filter predicate engine over 1M synthetic pending trades.
+// Usage: pending_trades_filter_bench [rows]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "report/RowFilter.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    report::FilterCondition Condition(const std::string&              column,
+                                      const std::string&              search_type,
+                                      const std::vector<std::string>& values) {
+        return report::FilterCondition{column, search_type, "", values};
+    }
+
+    void Run(const char*                                 name,
+             const std::vector<ReportTradeRecord>&       trades,
+             const std::vector<report::FilterCondition>& conditions) {
+        const report::RowFilter filter(conditions);
+
+        double best    = 1e300;
+        size_t matched = 0;
+        for (int run = 0; run < 5; ++run) {
+            std::vector<uint32_t> rows(trades.size());
+            std::iota(rows.begin(), rows.end(), 0);
+
+            const auto start = Clock::now();
+            filter.Apply(report::RowFilter::Stage::Trade, trades, rows);
+            const auto end = Clock::now();
+
+            best    = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            matched = rows.size();
+        }
+
+        std::printf("%-44s %10.2f %14.0f %10zu\n",
+                    name,
+                    best,
+                    static_cast<double>(trades.size()) / (best / 1000.0),
+                    matched);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t rows_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+
+    std::mt19937                   random(42);
+    std::vector<ReportTradeRecord> trades(rows_count);
+    for (size_t i = 0; i < rows_count; ++i) {
+        auto& trade      = trades[i];
+        trade.order      = static_cast<int>(i + 1);
+        trade.login      = static_cast<int>(100'000 + random() % 50'000);
+        trade.symbol     = "SYM" + std::to_string(random() % 20);
+        trade.cmd        = static_cast<ReportTradeCommand>(2 + random() % 4);
+        trade.volume     = static_cast<int>(random() % 10'000);
+        trade.open_time  = 1'700'000'000 + static_cast<time_t>(random() % 86'400);
+        trade.open_price = static_cast<double>(random() % 200'000) / 100.0;
+        trade.profit     = static_cast<double>(random() % 2'000'000) / 100.0 - 10'000.0;
+        trade.comment    = "client order #" + std::to_string(random() % 100'000);
+    }
+
+    std::printf("rows: %zu\n", rows_count);
+    std::printf("%-44s %10s %14s %10s\n", "filter", "best ms", "rows/s", "matched");
+
+    Run("symbol select", trades, {Condition("symbol", "select", {"SYM1", "SYM7"})});
+    Run("volume between", trades, {Condition("volume", "between", {"10", "40"})});
+    Run("type equal", trades, {Condition("type", "equal", {"Buy Limit"})});
+    Run("comment like", trades, {Condition("comment", "like", {"#123"})});
+    Run("open_time between", trades, {Condition("open_time", "between", {"1700010000", "1700050000"})});
+    Run("symbol + volume + login + profit",
+        trades,
+        {Condition("symbol", "select", {"SYM1", "SYM7", "SYM9"}),
+         Condition("volume", "between", {"10", "80"}),
+         Condition("login", "above_or_equal", {"120000"}),
+         Condition("profit", "below", {"0"})});
+    Run("symbol + volume + login + profit + like",
+        trades,
+        {Condition("symbol", "select", {"SYM1", "SYM7", "SYM9"}),
+         Condition("volume", "between", {"10", "80"}),
+         Condition("login", "above_or_equal", {"120000"}),
+         Condition("profit", "below", {"0"}),
+         Condition("comment", "like", {"#1"})});
+
+    return 0;
+}
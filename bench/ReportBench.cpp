@@ -0,0 +1,292 @@
+// End-to-end CreateReport over the synthetic server, loading the plugin the way the report
+// server does. Every (order count, worker pool size) pair runs in a forked child, so peak RSS
+// belongs to that case and the pool size, read once per process from PENDING_TRADES_WORKERS,
+// can change between cases. --threads sets the number of concurrent CreateReport callers.
+// --max-rss-spread-mib fails the run when the peak RSS of one order count differs by more than
+// that across the worker pool sizes, e.g. for a file export that must stay constant-memory:
+//   pending_trades_bench --sizes 1000000 --workers 1,8 --max-rss-spread-mib 32
+//                        --request '{"group":"*","from":0,"to":2147483647,"cache":false,
+//                                    "format":"csv","output":"file"}'
+// Usage: pending_trades_bench [--plugin path] [--sizes 1000,100000,1000000] [--threads 1,2,4]
+//                             [--workers 1,2,4] [--repeat n] [--request json] [--latency-us n]
+//                             [--days n] [--row-latency-ns n] [--max-rss-spread-mib n]
+
+#include <dlfcn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SyntheticServer.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    using CreateReportFn  = void (*)(rapidjson::Value&,
+                                    rapidjson::Value&,
+                                    rapidjson::Document::AllocatorType&,
+                                    ReportServerInterface*);
+    using DestroyReportFn = void (*)();
+
+    struct Options {
+        std::string         plugin  = PENDING_TRADES_PLUGIN_PATH;
+        std::vector<size_t> sizes   = {1'000, 100'000, 1'000'000};
+        std::vector<size_t> threads = {1};
+        std::vector<size_t> workers; // pool sizes; empty keeps the inherited environment
+        size_t              repeat  = 5;
+        std::string         request = R"({"group":"*","from":0,"to":2147483647,"cache":false})";
+        long                latency_us         = 0;
+        long                row_latency_ns     = 0; // per pending order returned by the server
+        int                 days               = 1; // open times of the data span this many days
+        double              max_rss_spread_mib = 0; // 0 - not checked
+    };
+
+    std::vector<size_t> ParseList(const char* text) {
+        std::vector<size_t> values;
+        char* end = nullptr;
+        for (const char* it = text; *it != '\0'; it = *end == ',' ? end + 1 : end) {
+            values.push_back(std::strtoul(it, &end, 10));
+            if (end == it) {
+                break;
+            }
+        }
+        return values;
+    }
+
+    bool ParseOptions(const int argc, char** argv, Options& options) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string name  = argv[i];
+            const char*       value = argv[i + 1];
+
+            if (name == "--plugin") {
+                options.plugin = value;
+            } else if (name == "--sizes") {
+                options.sizes = ParseList(value);
+            } else if (name == "--threads") {
+                options.threads = ParseList(value);
+            } else if (name == "--workers") {
+                options.workers = ParseList(value);
+            } else if (name == "--repeat") {
+                options.repeat = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+            } else if (name == "--request") {
+                options.request = value;
+            } else if (name == "--latency-us") {
+                options.latency_us = std::strtol(value, nullptr, 10);
+            } else if (name == "--row-latency-ns") {
+                options.row_latency_ns = std::strtol(value, nullptr, 10);
+            } else if (name == "--max-rss-spread-mib") {
+                options.max_rss_spread_mib = std::strtod(value, nullptr);
+            } else if (name == "--days") {
+                options.days = std::max(static_cast<int>(std::strtol(value, nullptr, 10)), 1);
+            } else {
+                std::fprintf(stderr, "unknown option %s\n", name.c_str());
+                return false;
+            }
+        }
+        return argc % 2 == 1;
+    }
+
+    // Peak resident set of this process, MiB
+    double PeakRssMiB() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;
+    }
+
+    int RunSize(const Options& options, const size_t orders_count, const size_t workers_count) {
+        // Must be set before the plugin creates its pool
+        if (workers_count > 0) {
+            setenv("PENDING_TRADES_WORKERS", std::to_string(workers_count).c_str(), 1);
+        }
+        const char* workers = std::getenv("PENDING_TRADES_WORKERS");
+
+        void* plugin = dlopen(options.plugin.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!plugin) {
+            std::fprintf(stderr, "dlopen: %s\n", dlerror());
+            return 1;
+        }
+
+        const auto create_report  = reinterpret_cast<CreateReportFn>(dlsym(plugin, "CreateReport"));
+        const auto destroy_report = reinterpret_cast<DestroyReportFn>(dlsym(plugin, "DestroyReport"));
+        if (!create_report || !destroy_report) {
+            std::fprintf(stderr, "dlsym: %s\n", dlerror());
+            return 1;
+        }
+
+        bench::SyntheticDataConfig config;
+        config.pending_count  = orders_count;
+        config.accounts_count = std::max<size_t>(orders_count / 10, 100);
+        config.days           = options.days;
+
+        bench::SyntheticLatency latency;
+        latency.account_by_login  = std::chrono::microseconds(options.latency_us);
+        latency.accounts_by_group = std::chrono::microseconds(options.latency_us);
+        latency.pending_trades    = std::chrono::microseconds(options.latency_us);
+        latency.pending_trade_row = std::chrono::nanoseconds(options.row_latency_ns);
+        latency.groups            = std::chrono::microseconds(options.latency_us);
+        latency.convert_rate      = std::chrono::microseconds(options.latency_us);
+
+        bench::SyntheticServer server(config, latency);
+        const double           data_rss = PeakRssMiB();
+
+        rapidjson::Document request;
+        request.Parse(options.request.c_str());
+        if (request.HasParseError()) {
+            std::fprintf(stderr, "invalid --request\n");
+            return 1;
+        }
+
+        for (const size_t threads_count : options.threads) {
+            std::vector<rapidjson::Document> responses(std::max<size_t>(threads_count, 1));
+
+            double   best_ms  = 1e300;
+            double   total_ms = 0.0;
+            uint64_t calls    = 0;
+
+            for (size_t run = 0; run < options.repeat; ++run) {
+                server.ResetCallCount();
+
+                // Concurrent callers share the server and the plugin's process-wide state
+                std::vector<std::thread> workers;
+                const auto               start = Clock::now();
+                for (auto& response : responses) {
+                    workers.emplace_back([&request, &response, &server, create_report] {
+                        rapidjson::Document local_request;
+                        local_request.CopyFrom(request, local_request.GetAllocator());
+                        response.SetObject();
+                        create_report(local_request, response, response.GetAllocator(), &server);
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                const double elapsed_ms =
+                    std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                best_ms = std::min(best_ms, elapsed_ms);
+                total_ms += elapsed_ms;
+                calls = server.GetCallCount();
+            }
+
+            rapidjson::StringBuffer                    buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            responses.front().Accept(writer);
+
+            const double rows_per_second =
+                static_cast<double>(orders_count * responses.size()) / (best_ms / 1000.0);
+
+            std::printf("%10zu %8s %8zu %10.2f %10.2f %14.0f %12.1f %10.1f %10.1f %8lu\n",
+                        orders_count,
+                        workers ? workers : "auto",
+                        responses.size(),
+                        best_ms,
+                        total_ms / static_cast<double>(options.repeat),
+                        rows_per_second,
+                        static_cast<double>(buffer.GetSize()) / 1024.0,
+                        data_rss,
+                        PeakRssMiB(),
+                        static_cast<unsigned long>(calls));
+            std::fflush(stdout);
+        }
+
+        destroy_report();
+        dlclose(plugin);
+        return 0;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    std::printf("plugin: %s, repeat: %zu, server latency: %ld us + %ld ns per order, days: %d\n",
+                options.plugin.c_str(),
+                options.repeat,
+                options.latency_us,
+                options.row_latency_ns,
+                options.days);
+    std::printf("%10s %8s %8s %10s %10s %14s %12s %10s %10s %8s\n",
+                "orders",
+                "workers",
+                "threads",
+                "best ms",
+                "mean ms",
+                "rows/s",
+                "resp KiB",
+                "data MiB",
+                "peak MiB",
+                "calls");
+    std::fflush(stdout);
+
+    // 0 leaves PENDING_TRADES_WORKERS as inherited
+    const std::vector<size_t> workers = options.workers.empty() ? std::vector<size_t>{0}
+                                                                : options.workers;
+
+    int status = 0;
+    for (const size_t orders_count : options.sizes) {
+        double min_rss_mib = 1e300;
+        double max_rss_mib = 0.0;
+
+        for (const size_t workers_count : workers) {
+            const pid_t child = fork();
+            if (child < 0) {
+                std::perror("fork");
+                return 1;
+            }
+            if (child == 0) {
+                _exit(RunSize(options, orders_count, workers_count));
+            }
+
+            int    child_status = 0;
+            rusage child_usage{};
+            wait4(child, &child_status, 0, &child_usage);
+
+            const double rss_mib = static_cast<double>(child_usage.ru_maxrss) / 1024.0;
+            min_rss_mib          = std::min(min_rss_mib, rss_mib);
+            max_rss_mib          = std::max(max_rss_mib, rss_mib);
+
+            if (WIFSIGNALED(child_status)) {
+                // SIGKILL here is usually the OOM killer
+                std::fprintf(stderr,
+                             "%zu orders, %zu workers: killed by signal %d\n",
+                             orders_count,
+                             workers_count,
+                             WTERMSIG(child_status));
+                status = 1;
+            } else if (WEXITSTATUS(child_status) != 0) {
+                std::fprintf(stderr,
+                             "%zu orders, %zu workers: run failed\n",
+                             orders_count,
+                             workers_count);
+                status = 1;
+            }
+        }
+
+        const double rss_spread_mib = max_rss_mib - min_rss_mib;
+        if (options.max_rss_spread_mib > 0 && rss_spread_mib > options.max_rss_spread_mib) {
+            std::fprintf(stderr,
+                         "%zu orders: peak RSS %.1f..%.1f MiB across worker counts, spread above "
+                         "%.1f MiB\n",
+                         orders_count,
+                         min_rss_mib,
+                         max_rss_mib,
+                         options.max_rss_spread_mib);
+            status = 1;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,108 @@
+// Server-side sort engine against std::sort over 1M synthetic pending trades.
+// Usage: pending_trades_sort_bench [rows] [window]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+#include "report/RowSorter.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    template <typename Fn>
+    double MeasureMs(const std::vector<uint32_t>& source, Fn&& fn) {
+        double best = 1e300;
+        for (int run = 0; run < 5; ++run) {
+            std::vector<uint32_t> rows = source;
+            const auto            start = Clock::now();
+            fn(rows);
+            const auto end = Clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t rows_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    const size_t window     = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    std::mt19937                   random(42);
+    std::vector<ReportTradeRecord> trades(rows_count);
+    for (size_t i = 0; i < rows_count; ++i) {
+        trades[i].order  = static_cast<int>(random() % 100'000'000);
+        trades[i].login  = static_cast<int>(100'000 + random() % 50'000);
+        trades[i].profit = static_cast<double>(random() % 2'000'000) / 100.0 - 10'000.0;
+    }
+
+    report::AccountIndex    account_index;
+    report::GroupIndex      group_index;
+    const report::RowSorter sorter(trades, account_index, group_index);
+
+    std::vector<uint32_t> source(rows_count);
+    std::iota(source.begin(), source.end(), 0);
+
+    const auto by_order_desc = [&trades](const uint32_t lhs, const uint32_t rhs) {
+        return trades[lhs].order != trades[rhs].order ? trades[lhs].order > trades[rhs].order
+                                                      : lhs < rhs;
+    };
+    const auto by_login_profit = [&trades](const uint32_t lhs, const uint32_t rhs) {
+        if (trades[lhs].login != trades[rhs].login) {
+            return trades[lhs].login < trades[rhs].login;
+        }
+        if (trades[lhs].profit != trades[rhs].profit) {
+            return trades[lhs].profit > trades[rhs].profit;
+        }
+        return lhs < rhs;
+    };
+
+    const std::vector<report::SortKey> order_desc = {{"order", true}};
+    const std::vector<report::SortKey> multi_key  = {{"login", false}, {"profit", true}};
+
+    std::printf("rows: %zu, window: %zu\n", rows_count, window);
+    std::printf("%-36s %10s\n", "case", "best ms");
+
+    std::printf("%-36s %10.2f\n", "std::sort order DESC", MeasureMs(source, [&](auto& rows) {
+        std::sort(rows.begin(), rows.end(), by_order_desc);
+    }));
+    std::printf("%-36s %10.2f\n", "RowSorter order DESC (radix)", MeasureMs(source, [&](auto& rows) {
+        sorter.Sort(rows, order_desc, rows.size());
+    }));
+    std::printf("%-36s %10.2f\n", "std::partial_sort order DESC top-K", MeasureMs(source, [&](auto& rows) {
+        std::partial_sort(rows.begin(), rows.begin() + window, rows.end(), by_order_desc);
+    }));
+    std::printf("%-36s %10.2f\n", "RowSorter order DESC top-K", MeasureMs(source, [&](auto& rows) {
+        sorter.Sort(rows, order_desc, window);
+    }));
+    std::printf("%-36s %10.2f\n", "std::sort login ASC, profit DESC", MeasureMs(source, [&](auto& rows) {
+        std::sort(rows.begin(), rows.end(), by_login_profit);
+    }));
+    std::printf("%-36s %10.2f\n", "RowSorter login ASC, profit DESC", MeasureMs(source, [&](auto& rows) {
+        sorter.Sort(rows, multi_key, rows.size());
+    }));
+
+    // Cross-check: the engine must agree with the reference comparators
+    std::vector<uint32_t> expected = source;
+    std::vector<uint32_t> actual   = source;
+    std::sort(expected.begin(), expected.end(), by_order_desc);
+    sorter.Sort(actual, order_desc, actual.size());
+    if (expected != actual) {
+        std::fprintf(stderr, "RowSorter order DESC differs from std::sort\n");
+        return 1;
+    }
+
+    expected = source;
+    actual   = source;
+    std::sort(expected.begin(), expected.end(), by_login_profit);
+    sorter.Sort(actual, multi_key, actual.size());
+    if (expected != actual) {
+        std::fprintf(stderr, "RowSorter login ASC, profit DESC differs from std::sort\n");
+        return 1;
+    }
+
+    return 0;
+}
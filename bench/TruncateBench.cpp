@@ -0,0 +1,122 @@
+// utils::TruncateDouble per cell (std::pow reference and power table) against the
+// TruncateDoubles column kernel, with a bit-for-bit check of all three.
+// Usage: pending_trades_truncate_bench [values] [digits]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "utils/Utils.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // TruncateDouble as it was before the power table
+    double ReferenceTruncate(const double value, const int digits) {
+        const double factor = std::pow(10.0, digits);
+        return std::trunc(value * factor) / factor;
+    }
+
+    bool SameBits(const double lhs, const double rhs) {
+        return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+    }
+
+    template <typename Fn>
+    double MeasureMs(Fn&& fn) {
+        double best = 1e300;
+        for (int run = 0; run < 5; ++run) {
+            const auto start = Clock::now();
+            fn();
+            best = std::min(
+                best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        return best;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t values_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8'000'000;
+    const int    digits       = argc > 2 ? std::atoi(argv[2]) : 2; // runtime, so pow is not folded
+
+    // Prices, volumes and swaps as they reach the row writer, plus the awkward values
+    std::mt19937_64                        random(42);
+    std::uniform_real_distribution<double> prices(-100'000.0, 100'000.0);
+    std::vector<double>                    values(values_count);
+    for (auto& value : values) {
+        value = random() % 4 == 0 ? static_cast<double>(random() % 1'000'000) / 100.0
+                                  : prices(random);
+    }
+    const double specials[] = {0.0,
+                               -0.0,
+                               0.005,
+                               -0.005,
+                               1.255,
+                               std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN(),
+                               std::numeric_limits<double>::max(),
+                               std::numeric_limits<double>::denorm_min()};
+    for (size_t i = 0; i < std::size(specials) && i < values.size(); ++i) {
+        values[i] = specials[i];
+    }
+
+    // Correctness: every digit count the report uses and a few it does not
+    std::vector<double> batch(values.size());
+    size_t              mismatches = 0;
+    for (const int check_digits : {0, 2, 5, 8, 22, 23, -1}) {
+        utils::TruncateDoubles(values.data(), values.size(), check_digits, batch.data());
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double expected = ReferenceTruncate(values[i], check_digits);
+            if (!SameBits(utils::TruncateDouble(values[i], check_digits), expected) ||
+                !SameBits(batch[i], expected)) {
+                ++mismatches;
+            }
+        }
+    }
+
+    std::printf("values: %zu, digits: %d, mismatches: %zu\n", values.size(), digits, mismatches);
+    std::printf("%-36s %10s %14s\n", "case", "best ms", "values/s");
+
+    double     sink   = 0.0;
+    const auto report = [&values](const char* name, const double ms) {
+        std::printf("%-36s %10.2f %14.0f\n",
+                    name,
+                    ms,
+                    static_cast<double>(values.size()) / (ms / 1000.0));
+    };
+
+    report("std::pow per cell", MeasureMs([&] {
+               for (size_t i = 0; i < values.size(); ++i) {
+                   batch[i] = ReferenceTruncate(values[i], digits);
+               }
+               sink += batch.back();
+           }));
+    report("TruncateDouble per cell", MeasureMs([&] {
+               for (size_t i = 0; i < values.size(); ++i) {
+                   batch[i] = utils::TruncateDouble(values[i], digits);
+               }
+               sink += batch.back();
+           }));
+    report("TruncateDoubles column", MeasureMs([&] {
+               utils::TruncateDoubles(values.data(), values.size(), digits, batch.data());
+               sink += batch.back();
+           }));
+    report("TruncateDoubles 256-row chunks", MeasureMs([&] {
+               for (size_t begin = 0; begin < values.size(); begin += 256) {
+                   utils::TruncateDoubles(values.data() + begin,
+                                          std::min<size_t>(256, values.size() - begin),
+                                          digits,
+                                          batch.data() + begin);
+               }
+               sink += batch.back();
+           }));
+
+    std::printf("(checksum %g)\n", sink);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,448 @@
+#include "SyntheticServer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace bench {
+    namespace {
+        constexpr ReportTradeCommand PENDING_COMMANDS[] = {ReportTradeCommand::BuyLimit,
+                                                           ReportTradeCommand::SellLimit,
+                                                           ReportTradeCommand::BuyStop,
+                                                           ReportTradeCommand::SellStop,
+                                                           ReportTradeCommand::BuyStopLimit,
+                                                           ReportTradeCommand::SellStopLimit};
+
+        constexpr const char* SYMBOL_CURRENCIES[] = {
+            "EUR", "USD", "GBP", "JPY", "CHF", "AUD", "CAD", "NZD", "XAU", "XAG"};
+
+        // `*` matches any run of characters
+        bool MatchWildcard(const char* pattern, const char* text) {
+            if (*pattern == '\0') {
+                return *text == '\0';
+            }
+            if (*pattern == '*') {
+                return MatchWildcard(pattern + 1, text) ||
+                       (*text != '\0' && MatchWildcard(pattern, text + 1));
+            }
+            return *text == *pattern && MatchWildcard(pattern + 1, text + 1);
+        }
+
+        std::string RandomText(std::mt19937& random, const size_t length) {
+            static constexpr char alphabet[] =
+                "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 #-_/";
+            std::string text(length, ' ');
+            for (auto& c : text) {
+                c = alphabet[random() % (sizeof(alphabet) - 1)];
+            }
+            return text;
+        }
+    } // namespace
+
+    SyntheticServer::SyntheticServer(const SyntheticDataConfig& config,
+                                     const SyntheticLatency&    latency)
+        : _config(config), _latency(latency) {
+        Generate();
+    }
+
+    bool SyntheticServer::MatchGroupMask(const std::string& mask, const std::string& group) {
+        bool   matched = false;
+        size_t begin   = 0;
+
+        while (begin <= mask.size()) {
+            size_t end = mask.find(',', begin);
+            if (end == std::string::npos) {
+                end = mask.size();
+            }
+
+            std::string pattern = mask.substr(begin, end - begin);
+            begin               = end + 1;
+            if (pattern.empty()) {
+                continue;
+            }
+
+            // Exclusions win over any inclusion
+            if (pattern[0] == '!') {
+                if (MatchWildcard(pattern.c_str() + 1, group.c_str())) {
+                    return false;
+                }
+            } else if (MatchWildcard(pattern.c_str(), group.c_str())) {
+                matched = true;
+            }
+        }
+
+        return matched;
+    }
+
+    void SyntheticServer::Generate() {
+        std::mt19937 random(_config.seed);
+
+        // Groups
+        _groups.resize(std::max<size_t>(_config.groups_count, 1));
+        for (size_t i = 0; i < _groups.size(); ++i) {
+            auto& group     = _groups[i];
+            group.grp_index = static_cast<int>(i);
+            group.currency  = _config.currencies[i % _config.currencies.size()];
+            group.group     = "real\\" + group.currency + "-" + std::to_string(i + 1);
+            group.enable    = 1;
+        }
+
+        // Symbols: currency crosses first, then numbered CFDs
+        for (const char* base : SYMBOL_CURRENCIES) {
+            for (const char* quote : SYMBOL_CURRENCIES) {
+                if (_symbols.size() < _config.symbols_count && std::string(base) != quote) {
+                    ReportSymbolRecord symbol;
+                    symbol.symbol   = std::string(base) + quote;
+                    symbol.currency = quote;
+                    symbol.digits   = std::string(quote) == "JPY" ? 3 : 5;
+                    _symbols.push_back(symbol);
+                }
+            }
+        }
+        while (_symbols.size() < std::max<size_t>(_config.symbols_count, 1)) {
+            ReportSymbolRecord symbol;
+            symbol.symbol   = "CFD" + std::to_string(_symbols.size());
+            symbol.currency = "USD";
+            symbol.digits   = 2;
+            _symbols.push_back(symbol);
+        }
+
+        std::vector<double> base_prices(_symbols.size());
+        for (auto& price : base_prices) {
+            price = 0.5 + static_cast<double>(random() % 200'000) / 100.0;
+        }
+
+        // Accounts
+        _accounts.resize(_config.accounts_count);
+        for (size_t i = 0; i < _accounts.size(); ++i) {
+            auto& account   = _accounts[i];
+            account.login   = _first_login + static_cast<int>(i);
+            account.group   = _groups[random() % _groups.size()].group;
+            account.name    = "Trader " + RandomText(random, 4 + random() % 28);
+            account.email   = "trader" + std::to_string(account.login) + "@example.com";
+            account.country = "Cyprus";
+            account.balance = static_cast<double>(random() % 10'000'000) / 100.0;
+            account.leverage = 100;
+        }
+
+        // Login popularity: Zipf weights over a shuffled rank, so heavy accounts are spread
+        // across groups
+        std::vector<double> login_cdf(_accounts.size());
+        std::vector<size_t> rank_to_account(_accounts.size());
+        std::iota(rank_to_account.begin(), rank_to_account.end(), 0);
+        std::shuffle(rank_to_account.begin(), rank_to_account.end(), random);
+
+        double total_weight = 0.0;
+        for (size_t rank = 0; rank < login_cdf.size(); ++rank) {
+            total_weight += 1.0 / std::pow(static_cast<double>(rank + 1), _config.login_skew);
+            login_cdf[rank] = total_weight;
+        }
+
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        const time_t                           time_span = static_cast<time_t>(_config.days) * 86'400;
+
+        // Pending orders, order ids grow with the position like a live server's
+        _trades.resize(_config.pending_count);
+        for (size_t i = 0; i < _trades.size(); ++i) {
+            auto& trade = _trades[i];
+
+            const size_t symbol_index = random() % _symbols.size();
+            const double base_price   = base_prices[symbol_index];
+
+            trade.order = 1'000'000 + static_cast<int>(i);
+            if (_accounts.empty() || unit(random) < _config.orphan_login_ratio) {
+                trade.login = _first_login + static_cast<int>(_accounts.size()) +
+                              static_cast<int>(random() % 1000);
+            } else {
+                const double point = unit(random) * total_weight;
+                const size_t rank  = std::min<size_t>(
+                    std::lower_bound(login_cdf.begin(), login_cdf.end(), point) - login_cdf.begin(),
+                    login_cdf.size() - 1);
+                trade.login = _accounts[rank_to_account[rank]].login;
+            }
+
+            trade.symbol     = _symbols[symbol_index].symbol;
+            trade.digits     = _symbols[symbol_index].digits;
+            trade.cmd        = PENDING_COMMANDS[random() % std::size(PENDING_COMMANDS)];
+            trade.volume     = 1 + static_cast<int>(random() % 10'000);
+            trade.open_time  = _config.day_start + (time_span > 0 ? random() % time_span : 0);
+            trade.state      = ReportTradeState::OpenNormal;
+            trade.open_price = base_price * (0.95 + unit(random) * 0.1);
+            trade.sl         = random() % 4 == 0 ? 0.0 : trade.open_price * 0.98;
+            trade.tp         = random() % 4 == 0 ? 0.0 : trade.open_price * 1.02;
+            trade.storage    = -static_cast<double>(random() % 10'000) / 100.0;
+            trade.profit     = static_cast<double>(random() % 2'000'000) / 100.0 - 10'000.0;
+            trade.comment    = RandomText(random, random() % (_config.max_comment_length + 1));
+        }
+    }
+
+    void SyntheticServer::Call(const std::chrono::microseconds latency) {
+        ++_calls;
+        Wait(latency);
+    }
+
+    void SyntheticServer::Wait(const std::chrono::microseconds latency) {
+        if (latency.count() <= 0) {
+            return;
+        }
+
+        // Spinning is far more precise than sleeping for microsecond latencies
+        if (latency >= std::chrono::milliseconds(1)) {
+            std::this_thread::sleep_for(latency);
+            return;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + latency;
+        while (std::chrono::steady_clock::now() < deadline) {
+        }
+    }
+
+    const ReportAccountRecord* SyntheticServer::FindAccount(const int login) const {
+        const long index = static_cast<long>(login) - _first_login;
+        if (index < 0 || index >= static_cast<long>(_accounts.size())) {
+            return nullptr;
+        }
+        return &_accounts[static_cast<size_t>(index)];
+    }
+
+    double SyntheticServer::GetCurrencyRate(const std::string& currency) const {
+        static const std::unordered_map<std::string, double> usd_rates = {
+            {"USD", 1.0}, {"EUR", 1.08}, {"GBP", 1.27}, {"JPY", 0.0067}, {"CHF", 1.12}};
+
+        const auto it = usd_rates.find(currency);
+        return it != usd_rates.end() ? it->second : 1.0;
+    }
+
+    int SyntheticServer::GetLogs(time_t, time_t, const std::string&, const std::string&, std::vector<ReportServerLog>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetAccountsByGroup(const std::string&                group,
+                                            std::vector<ReportAccountRecord>* accounts) {
+        Call(_latency.accounts_by_group);
+
+        std::unordered_map<std::string, bool> matches;
+        for (const auto& account : _accounts) {
+            const auto [it, inserted] = matches.try_emplace(account.group, false);
+            if (inserted) {
+                it->second = MatchGroupMask(group, account.group);
+            }
+            if (it->second) {
+                accounts->push_back(account);
+            }
+        }
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetAccountByLogin(const int login, ReportAccountRecord* account) {
+        Call(_latency.account_by_login);
+
+        const ReportAccountRecord* found = FindAccount(login);
+        if (!found) {
+            return RET_USER_NOT_FOUND;
+        }
+        *account = *found;
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetAccountBalanceByLogin(int, ReportMarginLevel*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetMarginLevelByGroup(const std::string&, std::vector<ReportMarginLevel>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetAccountsEquitiesByGroup(time_t, time_t, const std::string&, std::vector<ReportEquityRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetAccountsEquitiesByLogin(time_t, time_t, int, std::vector<ReportEquityRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetOpenTradesByLogin(int, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetPendingTradesByLogin(const int login, std::vector<ReportTradeRecord>* trades) {
+        Call(_latency.pending_trades);
+        for (const auto& trade : _trades) {
+            if (trade.login == login) {
+                trades->push_back(trade);
+            }
+        }
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetOpenTradesByMagic(int, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetOpenTradeByOrder(int, ReportTradeRecord*) {
+        Call(_latency.other);
+        return RET_ERR_NOTFOUND;
+    }
+
+    int SyntheticServer::GetOpenTradeByGwUUID(const std::string&, ReportTradeRecord*) {
+        Call(_latency.other);
+        return RET_ERR_NOTFOUND;
+    }
+
+    int SyntheticServer::GetCloseTradeByGwUUID(const std::string&, ReportTradeRecord*) {
+        Call(_latency.other);
+        return RET_ERR_NOTFOUND;
+    }
+
+    int SyntheticServer::GetOpenTradeByGwOrder(int, ReportTradeRecord*) {
+        Call(_latency.other);
+        return RET_ERR_NOTFOUND;
+    }
+
+    int SyntheticServer::GetCloseTradeByGwOrder(int, ReportTradeRecord*) {
+        Call(_latency.other);
+        return RET_ERR_NOTFOUND;
+    }
+
+    int SyntheticServer::GetCloseTradesByLogin(int, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetCloseTradesByGroup(const std::string&, time_t, time_t, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetPendingTradesByGroup(const std::string&              filter_group,
+                                                 const time_t                    from,
+                                                 const time_t                    to,
+                                                 std::vector<ReportTradeRecord>* trades) {
+        Call(_latency.pending_trades);
+
+        static const std::string no_group;
+        const size_t             count_before = trades->size();
+
+        std::unordered_map<std::string, bool> matches;
+        for (const auto& trade : _trades) {
+            if (trade.open_time < from || trade.open_time > to) {
+                continue;
+            }
+
+            const ReportAccountRecord* account = FindAccount(trade.login);
+            const std::string&         group   = account ? account->group : no_group;
+
+            const auto [it, inserted] = matches.try_emplace(group, false);
+            if (inserted) {
+                it->second = MatchGroupMask(filter_group, group);
+            }
+            if (it->second) {
+                trades->push_back(trade);
+            }
+        }
+
+        // Transfer cost grows with the range: a wider range returns more orders
+        Wait(std::chrono::duration_cast<std::chrono::microseconds>(
+            _latency.pending_trade_row * static_cast<int64_t>(trades->size() - count_before)));
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetOpenTradesByGroup(const std::string&, time_t, time_t, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetAllOpenTrades(std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetTransactionsByGroup(const std::string&, time_t, time_t, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetTransactionsByLogin(int, time_t, time_t, std::vector<ReportTradeRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+
+    int SyntheticServer::CalculateCommission(const ReportTradeRecord&, double* calculated_commission) {
+        Call(_latency.other);
+        *calculated_commission = 0.0;
+        return RET_OK;
+    }
+
+    int SyntheticServer::CalculateSwap(const ReportTradeRecord& trade, double* calculated_swap) {
+        Call(_latency.other);
+        *calculated_swap = trade.storage;
+        return RET_OK;
+    }
+
+    int SyntheticServer::CalculateProfit(const ReportTradeRecord& trade, double* calculated_profit) {
+        Call(_latency.other);
+        *calculated_profit = trade.profit;
+        return RET_OK;
+    }
+
+    int SyntheticServer::CalculateMargin(const ReportTradeRecord&, double* calculated_margin) {
+        Call(_latency.other);
+        *calculated_margin = 0.0;
+        return RET_OK;
+    }
+
+    int SyntheticServer::CalculateConvertRateByCurrency(const std::string& from_cur,
+                                                        const std::string& to_cur,
+                                                        const int          cmd,
+                                                        double*            multiplier) {
+        Call(_latency.convert_rate);
+
+        // Sell side converts at a slightly worse rate, like a bid/ask spread
+        const double spread = cmd % 2 == 0 ? 1.0 : 0.9995;
+        *multiplier         = GetCurrencyRate(from_cur) / GetCurrencyRate(to_cur) * spread;
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetSymbol(const std::string& symbol, ReportSymbolRecord* cs) {
+        Call(_latency.other);
+        for (const auto& record : _symbols) {
+            if (record.symbol == symbol) {
+                *cs = record;
+                return RET_OK;
+            }
+        }
+        return RET_SYMBOL_NOT_FOUND;
+    }
+
+    int SyntheticServer::GetGroup(const std::string& group_name, ReportGroupRecord* group) {
+        Call(_latency.other);
+        for (const auto& record : _groups) {
+            if (record.group == group_name) {
+                *group = record;
+                return RET_OK;
+            }
+        }
+        return RET_GROUP_NOT_FOUND;
+    }
+
+    int SyntheticServer::GetAllGroups(std::vector<ReportGroupRecord>* groups) {
+        Call(_latency.groups);
+        *groups = _groups;
+        return RET_OK;
+    }
+
+    int SyntheticServer::GetCandles(const std::string&, const std::string&, time_t, time_t, std::vector<ReportCandleRecord>*) {
+        Call(_latency.other);
+        return RET_OK;
+    }
+} // namespace bench
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ReportServerInterface.h"
+
+namespace bench {
+    // Shape of the generated data set. The same seed always yields the same data.
+    struct SyntheticDataConfig {
+        uint32_t seed = 42;
+
+        size_t groups_count   = 50;
+        size_t accounts_count = 10'000;
+        size_t symbols_count  = 100;
+        size_t pending_count  = 100'000;
+
+        // Group currencies are assigned round-robin from this list
+        std::vector<std::string> currencies = {"USD", "EUR", "GBP", "JPY", "CHF"};
+
+        // Zipf exponent of the login distribution over pending orders: 0 is uniform, ~1 puts a
+        // large share of orders on a few heavy accounts
+        double login_skew = 1.0;
+
+        // Comment lengths are uniform in [0, max_comment_length]
+        size_t max_comment_length = 64;
+
+        // Share of pending orders whose login has no account (exercises per-login fallbacks)
+        double orphan_login_ratio = 0.0;
+
+        // Open times are spread over [day_start, day_start + days * 86400)
+        time_t day_start = 1'700'000'000;
+        int    days      = 1;
+    };
+
+    // Simulated per-call cost of the server getters
+    struct SyntheticLatency {
+        std::chrono::microseconds account_by_login{0};
+        std::chrono::microseconds accounts_by_group{0};
+        std::chrono::microseconds pending_trades{0};
+        std::chrono::nanoseconds  pending_trade_row{0}; // per returned order, on top of the call
+        std::chrono::microseconds groups{0};
+        std::chrono::microseconds convert_rate{0};
+        std::chrono::microseconds other{0};
+    };
+
+    // In-memory ReportServerInterface over generated groups, accounts, symbols and pending
+    // orders. Group masks follow the server convention: comma separated patterns with `*`
+    // wildcards, `!` excludes. Safe to call from several threads.
+    class SyntheticServer final : public ReportServerInterface {
+    public:
+        explicit SyntheticServer(const SyntheticDataConfig& config = {},
+                                 const SyntheticLatency&    latency = {});
+
+        [[nodiscard]] const std::vector<ReportGroupRecord>&   GetGroups() const { return _groups; }
+        [[nodiscard]] const std::vector<ReportAccountRecord>& GetAccounts() const { return _accounts; }
+        [[nodiscard]] const std::vector<ReportTradeRecord>&   GetTrades() const { return _trades; }
+
+        void SetLatency(const SyntheticLatency& latency) { _latency = latency; }
+
+        // Number of server calls since construction or the last ResetCallCount()
+        [[nodiscard]] uint64_t GetCallCount() const { return _calls.load(); }
+        void                   ResetCallCount() { _calls = 0; }
+
+        static bool MatchGroupMask(const std::string& mask, const std::string& group);
+
+        int GetLogs(time_t from, time_t to, const std::string& type, const std::string& filter, std::vector<ReportServerLog>* logs) override;
+
+        int GetAccountsByGroup(const std::string& group, std::vector<ReportAccountRecord>* accounts) override;
+        int GetAccountByLogin(int login, ReportAccountRecord* account) override;
+        int GetAccountBalanceByLogin(int login, ReportMarginLevel* margin) override;
+        int GetMarginLevelByGroup(const std::string& group, std::vector<ReportMarginLevel>* margins) override;
+        int GetAccountsEquitiesByGroup(time_t from, time_t to, const std::string& group_filter, std::vector<ReportEquityRecord>* equities) override;
+        int GetAccountsEquitiesByLogin(time_t from, time_t to, int login, std::vector<ReportEquityRecord>* equities) override;
+
+        int GetOpenTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override;
+        int GetPendingTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override;
+        int GetOpenTradesByMagic(int magic, std::vector<ReportTradeRecord>* trades) override;
+        int GetOpenTradeByOrder(int order, ReportTradeRecord* trade) override;
+        int GetOpenTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) override;
+        int GetCloseTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) override;
+        int GetOpenTradeByGwOrder(int gw_order, ReportTradeRecord* trade) override;
+        int GetCloseTradeByGwOrder(int gw_order, ReportTradeRecord* trade) override;
+        int GetCloseTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override;
+        int GetCloseTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetPendingTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetOpenTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetAllOpenTrades(std::vector<ReportTradeRecord>* trades) override;
+        int GetTransactionsByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetTransactionsByLogin(int login, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+
+        int CalculateCommission(const ReportTradeRecord& trade, double* calculated_commission) override;
+        int CalculateSwap(const ReportTradeRecord& trade, double* calculated_swap) override;
+        int CalculateProfit(const ReportTradeRecord& trade, double* calculated_profit) override;
+        int CalculateMargin(const ReportTradeRecord& trade, double* calculated_margin) override;
+        int CalculateConvertRateByCurrency(const std::string& from_cur, const std::string& to_cur, int cmd, double* multiplier) override;
+
+        int GetSymbol(const std::string& symbol, ReportSymbolRecord* cs) override;
+        int GetGroup(const std::string& group_name, ReportGroupRecord* group) override;
+        int GetAllGroups(std::vector<ReportGroupRecord>* groups) override;
+
+        int GetCandles(const std::string& symbol, const std::string& frame, time_t from, time_t to, std::vector<ReportCandleRecord>* candles) override;
+
+    private:
+        SyntheticDataConfig _config;
+        SyntheticLatency    _latency;
+
+        std::vector<ReportGroupRecord>   _groups;
+        std::vector<ReportAccountRecord> _accounts;
+        std::vector<ReportSymbolRecord>  _symbols;
+        std::vector<ReportTradeRecord>   _trades;
+
+        // Accounts are generated with consecutive logins starting here
+        int _first_login = 100'000;
+
+        std::atomic<uint64_t> _calls{0};
+
+        void Generate();
+        void Call(std::chrono::microseconds latency);
+        static void Wait(std::chrono::microseconds latency);
+
+        [[nodiscard]] const ReportAccountRecord* FindAccount(int login) const;
+        [[nodiscard]] double                     GetCurrencyRate(const std::string& currency) const;
+    };
+} // namespace bench
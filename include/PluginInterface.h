@@ -11,6 +11,23 @@
 #include "sbxTableBuilder/SBXTableBuilder.hpp"
 #include "utils/Utils.h"
 #include "structures/ReportType.h"
+#include "report/AccountIndex.h"
+#include "report/Allocators.h"
+#include "report/ColumnarExport.h"
+#include "report/CountingServer.h"
+#include "report/CsvExport.h"
+#include "report/CurrencyConversion.h"
+#include "report/GroupIndex.h"
+#include "report/PendingTradesView.h"
+#include "report/Pagination.h"
+#include "report/PerfTrace.h"
+#include "report/RangeFetch.h"
+#include "report/ReportRequest.h"
+#include "report/ResultCache.h"
+#include "report/RowPipeline.h"
+#include "report/RowFilter.h"
+#include "report/RowSorter.h"
+#include "report/WorkerPool.h"
 
 using namespace ast;
 
@@ -26,4 +43,8 @@ extern "C" {
                      rapidjson::Value& response,
                      rapidjson::Document::AllocatorType& allocator,
                      ReportServerInterface* server);
+
+    // Trade event feed (EventType / EventRecordType from Structures.h), keeps the pending
+    // trades view current
+    void OnTradeEvent(int event_type, int record_type, const ReportTradeRecord& trade);
 }
\ No newline at end of file
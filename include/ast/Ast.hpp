@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
-#include <vector>
-#include <map>
-#include <variant>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
@@ -13,94 +19,553 @@ namespace ast {
 
     using namespace rapidjson;
 
+    // ====================== Memory ======================
+
+    /**
+     * Memory resource used by AST containers created on this thread.
+     * Defaults to the global heap; ArenaScope / ResourceScope replace it
+     * for their lifetime.
+     */
+    inline std::pmr::memory_resource*& current_resource() {
+        thread_local std::pmr::memory_resource* resource = std::pmr::new_delete_resource();
+        return resource;
+    }
+
+    /**
+     * Allocator of the AST containers. A default-constructed allocator
+     * (and so every default-constructed string, array, object and node)
+     * takes the thread's current resource and keeps it for the container's
+     * lifetime; copies pick the resource current at the time of the copy.
+     */
+    template <typename T>
+    class Allocator {
+    public:
+        using value_type = T;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+
+        Allocator() noexcept : _resource(current_resource()) {}
+        explicit Allocator(std::pmr::memory_resource* resource) noexcept : _resource(resource) {}
+
+        template <typename U>
+        Allocator(const Allocator<U>& other) noexcept : _resource(other.resource()) {}
+
+        T* allocate(const size_t count) {
+            return static_cast<T*>(_resource->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* pointer, const size_t count) noexcept {
+            _resource->deallocate(pointer, count * sizeof(T), alignof(T));
+        }
+
+        Allocator select_on_container_copy_construction() const { return Allocator(); }
+
+        [[nodiscard]] std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& other) const noexcept {
+            return _resource == other.resource() || _resource->is_equal(*other.resource());
+        }
+
+    private:
+        std::pmr::memory_resource* _resource;
+    };
+
+    /**
+     * Makes `resource` the current resource of this thread until the
+     * scope ends.
+     */
+    class ResourceScope {
+    public:
+        explicit ResourceScope(std::pmr::memory_resource* resource)
+            : _previous(std::exchange(current_resource(), resource)) {}
+
+        ~ResourceScope() { current_resource() = _previous; }
+
+        ResourceScope(const ResourceScope&) = delete;
+        ResourceScope& operator=(const ResourceScope&) = delete;
+
+    private:
+        std::pmr::memory_resource* _previous;
+    };
+
+    /**
+     * Per-report monotonic arena: AST values built on this thread while
+     * the scope is alive are bump-allocated from it and released all at
+     * once when it ends. Every such value must be destroyed before the
+     * scope - declare the scope first. Values that have to outlive it
+     * are built under a ResourceScope of the heap.
+     */
+    class ArenaScope {
+    public:
+        explicit ArenaScope(const size_t initial_size = 64 * 1024)
+            : _arena(initial_size), _scope(&_arena) {}
+
+    private:
+        std::pmr::monotonic_buffer_resource _arena;
+        ResourceScope                       _scope;
+    };
+
     // ====================== JSONValue ======================
 
-    struct JSONValue;
-    using JSONArray  = std::vector<JSONValue>;
-    using JSONObject = std::map<std::string, JSONValue>;
+    class JSONValue;
+    class JSONObject;
+    using String    = std::basic_string<char, std::char_traits<char>, Allocator<char>>;
+    using JSONArray = std::vector<JSONValue, Allocator<JSONValue>>;
+
+    /**
+     * Value produced at serialization time: the writer fills the output
+     * rapidjson value directly, so large payloads (table rows) never exist
+     * as a JSONValue tree. Everything the writer captures must outlive
+     * the serialization call.
+     */
+    struct JSONDeferred {
+        std::function<void(Value&, Document::AllocatorType&)> write;
+    };
+
+    /**
+     * String with static storage duration (literals, constexpr tables).
+     * Serialized by reference with StringRef instead of being copied into
+     * the allocator, so the view must be null-terminated and outlive the
+     * response.
+     */
+    struct JSONStaticString {
+        std::string_view value;
+    };
 
     /**
      * Represents a dynamic JSON-like value that can store:
-     * - string
+     * - string (up to SMALL_STRING_CAPACITY chars inline, longer ones
+     *   in a single allocation from the current resource)
+     * - static string (JSONStaticString)
      * - double
+     * - integer
      * - bool
      * - array (JSONArray)
      * - object (JSONObject)
+     * - deferred value (JSONDeferred)
+     *
+     * 16 bytes: the payload (number, pointer + length, or inline chars)
+     * and a one-byte tag. Arrays, objects and deferred values are boxed.
+     * A default-constructed value is an empty string.
+     */
+    class JSONValue {
+    public:
+        enum class Type : uint8_t {
+            String,
+            StaticString,
+            Number,
+            Integer,
+            Bool,
+            Array,
+            Object,
+            Deferred
+        };
+
+        static constexpr size_t SMALL_STRING_CAPACITY = 14;
+
+        JSONValue() noexcept { _small_length = 0; _type = Type::String; }
+        JSONValue(const char* s) { SetString(s, std::strlen(s)); }
+        JSONValue(const std::string& s) { SetString(s.data(), s.size()); }
+        JSONValue(const String& s) { SetString(s.data(), s.size()); }
+        JSONValue(JSONStaticString s) {
+            SetView(Type::StaticString, s.value.data(), s.value.size());
+        }
+        JSONValue(double d) { Store(0, d); _type = Type::Number; }
+        JSONValue(bool b) { Store(0, b); _type = Type::Bool; }
+
+        template <typename T,
+                  std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                       !std::is_same_v<T, char>,
+                                   int> = 0>
+        JSONValue(T i) {
+            Store(0, static_cast<int64_t>(i));
+            _type = Type::Integer;
+        }
+
+        JSONValue(const JSONArray& arr) { SetBox<JSONArray>(Type::Array, arr); }
+        JSONValue(JSONArray&& arr) { SetBox<JSONArray>(Type::Array, std::move(arr)); }
+        JSONValue(const JSONObject& obj);
+        JSONValue(JSONObject&& obj);
+        JSONValue(JSONDeferred deferred) {
+            SetBox<JSONDeferred>(Type::Deferred, std::move(deferred));
+        }
+
+        JSONValue(const JSONValue& other) { CopyFrom(other); }
+
+        JSONValue(JSONValue&& other) noexcept {
+            std::memcpy(static_cast<void*>(this), &other, sizeof(JSONValue));
+            other._small_length = 0;
+            other._type         = Type::String;
+        }
+
+        JSONValue& operator=(JSONValue other) noexcept {
+            Release();
+            std::memcpy(static_cast<void*>(this), &other, sizeof(JSONValue));
+            other._small_length = 0;
+            other._type         = Type::String;
+            return *this;
+        }
+
+        ~JSONValue() { Release(); }
+
+        [[nodiscard]] Type type() const { return _type; }
+
+        [[nodiscard]] bool is_string() const {
+            return _type == Type::String || _type == Type::StaticString;
+        }
+
+        // String or static string
+        [[nodiscard]] std::string_view string() const {
+            if (_type == Type::String && _small_length != LONG_STRING) {
+                return {_bytes, _small_length};
+            }
+            return {Load<const char*>(0), Load<uint32_t>(8)};
+        }
+
+        [[nodiscard]] double number() const { return Load<double>(0); }
+        [[nodiscard]] int64_t integer() const { return Load<int64_t>(0); }
+        [[nodiscard]] bool boolean() const { return Load<bool>(0); }
+
+        [[nodiscard]] const JSONArray& array() const { return Unbox<JSONArray>(); }
+        [[nodiscard]] JSONArray& array() { return Unbox<JSONArray>(); }
+        [[nodiscard]] const JSONObject& object() const;
+        [[nodiscard]] JSONObject& object();
+        [[nodiscard]] const JSONDeferred& deferred() const { return Unbox<JSONDeferred>(); }
+
+    private:
+        // _small_length of a string kept out of line
+        static constexpr uint8_t LONG_STRING = 0xFF;
+
+        // Boxed alternatives and long strings remember the resource they came from
+        template <typename T>
+        struct Box {
+            std::pmr::memory_resource* resource;
+            T                          value;
+        };
+
+        // Bytes 0..7: number, integer, bool or pointer; 8..11: string length.
+        // Inline strings use bytes 0..13.
+        alignas(8) char _bytes[SMALL_STRING_CAPACITY];
+        uint8_t _small_length;
+        Type    _type;
+
+        template <typename T>
+        T Load(const size_t offset) const {
+            T value;
+            std::memcpy(&value, _bytes + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void Store(const size_t offset, const T value) {
+            std::memcpy(_bytes + offset, &value, sizeof(T));
+        }
+
+        void SetView(const Type type, const char* data, const size_t length) {
+            Store(0, data);
+            Store(8, static_cast<uint32_t>(length));
+            _small_length = LONG_STRING;
+            _type         = type;
+        }
+
+        void SetString(const char* data, const size_t length) {
+            _type = Type::String;
+            if (length <= SMALL_STRING_CAPACITY) {
+                std::memcpy(_bytes, data, length);
+                _small_length = static_cast<uint8_t>(length);
+                return;
+            }
+
+            // [resource][chars][\0]
+            std::pmr::memory_resource* resource = current_resource();
+            auto* block = static_cast<char*>(resource->allocate(sizeof(resource) + length + 1,
+                                                                alignof(std::pmr::memory_resource*)));
+            std::memcpy(block, &resource, sizeof(resource));
+            std::memcpy(block + sizeof(resource), data, length);
+            block[sizeof(resource) + length] = '\0';
+            SetView(Type::String, block + sizeof(resource), length);
+        }
+
+        template <typename T, typename Arg>
+        void SetBox(const Type type, Arg&& value) {
+            std::pmr::memory_resource* resource = current_resource();
+            void* memory = resource->allocate(sizeof(Box<T>), alignof(Box<T>));
+            try {
+                Store(0, new (memory) Box<T>{resource, T(std::forward<Arg>(value))});
+            } catch (...) {
+                resource->deallocate(memory, sizeof(Box<T>), alignof(Box<T>));
+                throw;
+            }
+            _type = type;
+        }
+
+        template <typename T>
+        T& Unbox() const {
+            return Load<Box<T>*>(0)->value;
+        }
+
+        template <typename T>
+        void DestroyBox() {
+            auto* box = Load<Box<T>*>(0);
+            std::pmr::memory_resource* resource = box->resource;
+            box->~Box<T>();
+            resource->deallocate(box, sizeof(Box<T>), alignof(Box<T>));
+        }
+
+        void CopyFrom(const JSONValue& other);
+        void Release() noexcept;
+    };
+
+    /**
+     * JSON object: entries in insertion order (which is also the
+     * serialization order) plus their indices sorted by key for lookup.
+     * A flat replacement of std::map for the small objects of the AST;
+     * references returned by operator[] are invalidated by the next insert.
      */
-    struct JSONValue {
-        std::variant<std::string, double, bool, JSONArray, JSONObject> value;
-
-        JSONValue() = default;
-        JSONValue(const char* s) : value(std::string(s)) {}
-        JSONValue(const std::string& s) : value(s) {}
-        JSONValue(double d) : value(d) {}
-        JSONValue(bool b) : value(b) {}
-        JSONValue(const JSONArray& arr) : value(arr) {}
-        JSONValue(const JSONObject& obj) : value(obj) {}
+    class JSONObject {
+    public:
+        using value_type     = std::pair<String, JSONValue>;
+        using Entries        = std::vector<value_type, Allocator<value_type>>;
+        using iterator       = Entries::iterator;
+        using const_iterator = Entries::const_iterator;
+
+        JSONObject() = default;
+
+        // The first of duplicate keys wins, as with std::map
+        JSONObject(std::initializer_list<std::pair<const String, JSONValue>> entries) {
+            reserve(entries.size());
+            for (const auto& [key, value] : entries) {
+                if (const auto [position, is_found] = Locate(key); !is_found) {
+                    Insert(position, key, value);
+                }
+            }
+        }
+
+        JSONValue& operator[](const std::string_view key) {
+            const auto [position, is_found] = Locate(key);
+            if (is_found) {
+                return _entries[_sorted[position]].second;
+            }
+            return Insert(position, key, JSONValue());
+        }
+
+        [[nodiscard]] iterator find(const std::string_view key) {
+            const auto [position, is_found] = Locate(key);
+            return is_found ? _entries.begin() + _sorted[position] : _entries.end();
+        }
+
+        [[nodiscard]] const_iterator find(const std::string_view key) const {
+            const auto [position, is_found] = Locate(key);
+            return is_found ? _entries.begin() + _sorted[position] : _entries.end();
+        }
+
+        [[nodiscard]] bool contains(const std::string_view key) const { return Locate(key).second; }
+
+        [[nodiscard]] size_t size() const { return _entries.size(); }
+        [[nodiscard]] bool empty() const { return _entries.empty(); }
+
+        void reserve(const size_t count) {
+            _entries.reserve(count);
+            _sorted.reserve(count);
+        }
+
+        [[nodiscard]] iterator begin() { return _entries.begin(); }
+        [[nodiscard]] iterator end() { return _entries.end(); }
+        [[nodiscard]] const_iterator begin() const { return _entries.begin(); }
+        [[nodiscard]] const_iterator end() const { return _entries.end(); }
+
+    private:
+        Entries                                    _entries;
+        std::vector<uint32_t, Allocator<uint32_t>> _sorted;
+
+        // Position of the key in _sorted (or where it would go) and whether it is there
+        [[nodiscard]] std::pair<size_t, bool> Locate(const std::string_view key) const {
+            const auto is_less = [this](const uint32_t index, const std::string_view k) {
+                return std::string_view(_entries[index].first) < k;
+            };
+            const auto it = std::lower_bound(_sorted.begin(), _sorted.end(), key, is_less);
+            const auto position = static_cast<size_t>(it - _sorted.begin());
+            return {position, it != _sorted.end() && std::string_view(_entries[*it].first) == key};
+        }
+
+        JSONValue& Insert(const size_t position, const std::string_view key, JSONValue value) {
+            _entries.emplace_back(String(key), std::move(value));
+            _sorted.insert(_sorted.begin() + static_cast<std::ptrdiff_t>(position),
+                           static_cast<uint32_t>(_entries.size() - 1));
+            return _entries.back().second;
+        }
     };
 
+    inline JSONValue::JSONValue(const JSONObject& obj) { SetBox<JSONObject>(Type::Object, obj); }
+
+    inline JSONValue::JSONValue(JSONObject&& obj) {
+        SetBox<JSONObject>(Type::Object, std::move(obj));
+    }
+
+    inline const JSONObject& JSONValue::object() const { return Unbox<JSONObject>(); }
+
+    inline JSONObject& JSONValue::object() { return Unbox<JSONObject>(); }
+
+    inline void JSONValue::CopyFrom(const JSONValue& other) {
+        switch (other._type) {
+            case Type::String:
+                if (other._small_length == LONG_STRING) {
+                    const std::string_view value = other.string();
+                    SetString(value.data(), value.size());
+                    return;
+                }
+                break;
+            case Type::Array: SetBox<JSONArray>(Type::Array, other.array()); return;
+            case Type::Object: SetBox<JSONObject>(Type::Object, other.object()); return;
+            case Type::Deferred: SetBox<JSONDeferred>(Type::Deferred, other.deferred()); return;
+            default: break;
+        }
+        std::memcpy(static_cast<void*>(this), &other, sizeof(JSONValue));
+    }
+
+    inline void JSONValue::Release() noexcept {
+        switch (_type) {
+            case Type::String:
+                if (_small_length == LONG_STRING) {
+                    const size_t length = Load<uint32_t>(8);
+                    char* block = const_cast<char*>(Load<const char*>(0)) -
+                                  sizeof(std::pmr::memory_resource*);
+                    std::pmr::memory_resource* resource;
+                    std::memcpy(&resource, block, sizeof(resource));
+                    resource->deallocate(block,
+                                         sizeof(resource) + length + 1,
+                                         alignof(std::pmr::memory_resource*));
+                }
+                break;
+            case Type::Array: DestroyBox<JSONArray>(); break;
+            case Type::Object: DestroyBox<JSONObject>(); break;
+            case Type::Deferred: DestroyBox<JSONDeferred>(); break;
+            default: break;
+        }
+        _small_length = 0;
+        _type         = Type::String;
+    }
+
+    static_assert(sizeof(JSONValue) == 16);
+
     // Recursive serialization for JSONValue
     inline void to_json_value(const JSONValue& jv, Value& out, Document::AllocatorType& alloc) {
-        std::visit([&](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, std::string>)
-                out.SetString(arg.c_str(), alloc);
-            else if constexpr (std::is_same_v<T, double>)
-                out.SetDouble(arg);
-            else if constexpr (std::is_same_v<T, bool>)
-                out.SetBool(arg);
-            else if constexpr (std::is_same_v<T, JSONArray>) {
+        switch (jv.type()) {
+            case JSONValue::Type::String: {
+                const std::string_view value = jv.string();
+                out.SetString(value.data(), static_cast<SizeType>(value.size()), alloc);
+                break;
+            }
+            case JSONValue::Type::StaticString: {
+                const std::string_view value = jv.string();
+                out.SetString(StringRef(value.data(), value.size()));
+                break;
+            }
+            case JSONValue::Type::Number:
+                out.SetDouble(jv.number());
+                break;
+            case JSONValue::Type::Integer:
+                out.SetInt64(jv.integer());
+                break;
+            case JSONValue::Type::Bool:
+                out.SetBool(jv.boolean());
+                break;
+            case JSONValue::Type::Array:
                 out.SetArray();
-                for (const auto& el : arg) {
+                out.Reserve(static_cast<SizeType>(jv.array().size()), alloc);
+                for (const auto& el : jv.array()) {
                     Value item;
                     to_json_value(el, item, alloc);
                     out.PushBack(item, alloc);
                 }
-            } else if constexpr (std::is_same_v<T, JSONObject>) {
+                break;
+            case JSONValue::Type::Object:
                 out.SetObject();
-                for (const auto& [k, v] : arg) {
-                    Value key(k.c_str(), alloc);
+                out.MemberReserve(static_cast<SizeType>(jv.object().size()), alloc);
+                for (const auto& [k, v] : jv.object()) {
+                    Value key(k.c_str(), static_cast<SizeType>(k.size()), alloc);
                     Value val;
                     to_json_value(v, val, alloc);
                     out.AddMember(key, val, alloc);
                 }
-            }
-        }, jv.value);
+                break;
+            case JSONValue::Type::Deferred:
+                jv.deferred().write(out, alloc);
+                break;
+        }
     }
 
     // ====================== Node AST ======================
 
+    struct Node;
+    using NodeList   = std::vector<Node, Allocator<Node>>;
+    using SharedNode = std::shared_ptr<const Node>;
+
+    /**
+     * A node is either an element (type, props, children) or a reference
+     * to a shared immutable subtree, which is serialized in its place.
+     * Shared subtrees are never copied when the referencing node is.
+     */
     struct Node {
-        std::string type;
+        String type;
         JSONObject props;
-        std::vector<Node> children;
+        NodeList children;
+        SharedNode shared;
     };
 
     // ---------- Constructors ----------
 
     inline Node element(
-        const std::string& type,
-        std::vector<Node> children = {},
+        std::string_view type,
+        NodeList children = {},
         JSONObject props = {}
     ) {
-        return Node{type, std::move(props), std::move(children)};
+        return Node{String(type), std::move(props), std::move(children), {}};
     }
 
     inline Node text(const std::string& value) {
-        return Node{"#text", {{"value", JSONValue(value)}}, {}};
+        return Node{"#text", {{"value", JSONValue(value)}}, {}, {}};
+    }
+
+    /**
+     * Child list built by moving the nodes in: unlike a braced list,
+     * whose elements are const and copied, it never duplicates a subtree.
+     */
+    template <typename... Nodes>
+    NodeList nodes(Nodes&&... items) {
+        NodeList list;
+        list.reserve(sizeof...(items));
+        (list.emplace_back(std::forward<Nodes>(items)), ...);
+        return list;
+    }
+
+    /**
+     * Freezes a subtree so that several trees (or reports) can reference it
+     * through ref(). Its containers keep the resource they were built with:
+     * a subtree that outlives the report arena is built under a
+     * ResourceScope of the heap.
+     */
+    inline SharedNode share(Node node) {
+        return std::allocate_shared<Node>(Allocator<Node>(), std::move(node));
+    }
+
+    inline Node ref(SharedNode node) {
+        return Node{{}, {}, {}, std::move(node)};
     }
 
     // ---------- TAG macro ----------
 
     #define TAG(name) \
-    inline Node name(std::vector<Node> children = {}, JSONObject props = {}) { \
+    inline Node name(NodeList children = {}, JSONObject props = {}) { \
         return element(#name, std::move(children), std::move(props)); \
     }
 
     // ---------- TAG with type macro ----------
 
     #define TAG_WITH_TYPE(func_name, type_name) \
-    inline Node func_name(std::vector<Node> children = {}, JSONObject props = {}) { \
+    inline Node func_name(NodeList children = {}, JSONObject props = {}) { \
         return element(type_name, std::move(children), std::move(props)); \
     }
 
@@ -181,20 +646,27 @@ namespace ast {
 
     // ---------- Props helper ----------
 
-    inline JSONObject props(std::initializer_list<std::pair<const std::string, JSONValue>> kv) {
+    inline JSONObject props(std::initializer_list<std::pair<const String, JSONValue>> kv) {
         return JSONObject(kv);
     }
 
     // ---------- Serialization ----------
 
     inline void to_json(const Node& node, Value& out, Document::AllocatorType& alloc) {
+        if (node.shared) {
+            to_json(*node.shared, out, alloc);
+            return;
+        }
+
         out.SetObject();
-        out.AddMember("type", Value(node.type.c_str(), alloc), alloc);
+        out.AddMember(
+            "type", Value(node.type.c_str(), static_cast<SizeType>(node.type.size()), alloc), alloc);
 
         if (!node.props.empty()) {
             Value propsObj(kObjectType);
+            propsObj.MemberReserve(static_cast<SizeType>(node.props.size()), alloc);
             for (auto& [k, v] : node.props) {
-                Value key(k.c_str(), alloc);
+                Value key(k.c_str(), static_cast<SizeType>(k.size()), alloc);
                 Value val;
                 to_json_value(v, val, alloc);
                 propsObj.AddMember(key, val, alloc);
@@ -204,6 +676,7 @@ namespace ast {
 
         if (!node.children.empty()) {
             Value childrenArr(kArrayType);
+            childrenArr.Reserve(static_cast<SizeType>(node.children.size()), alloc);
             for (auto& c : node.children) {
                 Value child(kObjectType);
                 to_json(c, child, alloc);
@@ -228,5 +701,5 @@ namespace ast {
 
     // ---------- none helper ----------
 
-    inline std::vector<Node> none() { return {}; }
+    inline NodeList none() { return {}; }
 }
\ No newline at end of file
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast/Ast.hpp"
+
+using namespace ast;
+
+// Приёмник строк таблицы: ячейки передаются по одной, без промежуточного JSONValue
+class RowWriter {
+public:
+    virtual ~RowWriter() = default;
+
+    virtual void BeginRow() = 0;
+    virtual void EndRow() = 0;
+
+    virtual void String(const char* value, size_t length) = 0;
+    virtual void Number(double value) = 0;
+    virtual void Integer(int64_t value) = 0;
+    virtual void Bool(bool value) = 0;
+
+    // Произвольное значение (массив, объект) - медленный путь
+    virtual void Cell(const JSONValue& value) = 0;
+
+    // Строка со статическим временем жизни (литерал, constexpr-таблица), должна оканчиваться
+    // нулём. Приёмник может сослаться на неё без копирования.
+    virtual void StaticString(const std::string_view value) { String(value.data(), value.size()); }
+
+    // Строка из небольшого множества значений (символ, валюта, группа): приёмник может
+    // скопировать каждое значение один раз на отчёт и дальше ссылаться на копию
+    virtual void InternedString(const char* value, const size_t length) { String(value, length); }
+
+    void String(const std::string& value) { String(value.data(), value.size()); }
+
+    void InternedString(const std::string& value) { InternedString(value.data(), value.size()); }
+};
+
+// Колоночное хранилище строк таблицы: числа лежат непрерывными массивами,
+// строки - в общей арене колонки со смещениями
+class ColumnStore {
+public:
+    // Тип колонки определяется первой записанной ячейкой
+    enum class ColumnKind : uint8_t {
+        Empty,   // ещё нет ни одной ячейки
+        Number,  // double
+        Integer, // int64
+        Bool,    // bool
+        String,  // арена + смещения
+        Mixed    // разнотипные ячейки - JSONValue на ячейку
+    };
+
+    explicit ColumnStore(const size_t columns_count = 0) { SetColumnsCount(columns_count); }
+
+    void SetColumnsCount(const size_t columns_count) {
+        const size_t current_count = _columns.size();
+        if (columns_count <= current_count) {
+            return;
+        }
+
+        _columns.resize(columns_count);
+
+        // Колонки, добавленные после строк, заполняем пустыми строками
+        for (size_t column = current_count; column < columns_count && _rows_count > 0; ++column) {
+            for (size_t row = 0; row < _rows_count; ++row) {
+                AppendString(column, "", 0);
+            }
+        }
+    }
+
+    void Reserve(const size_t rows_count) { _reserved_rows = rows_count; }
+
+    [[nodiscard]] size_t ColumnsCount() const { return _columns.size(); }
+
+    [[nodiscard]] size_t RowsCount() const { return _rows_count; }
+
+    [[nodiscard]] ColumnKind GetColumnKind(const size_t column) const { return _columns[column].kind; }
+
+    // Добавление строки из готовых значений (совместимость с TableBuilder::AddRow)
+    void AddRow(const std::vector<JSONValue>& row_values) {
+        SetColumnsCount(row_values.size());
+
+        for (size_t column = 0; column < _columns.size(); ++column) {
+            if (column < row_values.size()) {
+                AppendValue(column, row_values[column]);
+            } else {
+                AppendString(column, "", 0);
+            }
+        }
+
+        ++_rows_count;
+    }
+
+    // Построчная запись ячеек: Append* по всем колонкам, затем CommitRow()
+    void AppendString(const size_t column, const char* value, const size_t length) {
+        Column& col = Prepare(column, ColumnKind::String);
+        if (col.kind == ColumnKind::Mixed) {
+            col.values.emplace_back(std::string(value, length));
+            return;
+        }
+        col.arena.append(value, length);
+        col.offsets.push_back(col.arena.size());
+    }
+
+    void AppendNumber(const size_t column, const double value) {
+        Column& col = Prepare(column, ColumnKind::Number);
+        if (col.kind == ColumnKind::Mixed) {
+            col.values.emplace_back(value);
+            return;
+        }
+        col.numbers.push_back(value);
+    }
+
+    void AppendInteger(const size_t column, const int64_t value) {
+        Column& col = Prepare(column, ColumnKind::Integer);
+        if (col.kind == ColumnKind::Mixed) {
+            col.values.emplace_back(JSONValue(value));
+            return;
+        }
+        col.integers.push_back(value);
+    }
+
+    void AppendBool(const size_t column, const bool value) {
+        Column& col = Prepare(column, ColumnKind::Bool);
+        if (col.kind == ColumnKind::Mixed) {
+            col.values.emplace_back(value);
+            return;
+        }
+        col.flags.push_back(value ? 1 : 0);
+    }
+
+    void AppendValue(const size_t column, const JSONValue& value) {
+        switch (value.type()) {
+            case JSONValue::Type::String:
+            case JSONValue::Type::StaticString: {
+                const std::string_view str = value.string();
+                AppendString(column, str.data(), str.size());
+                break;
+            }
+            case JSONValue::Type::Number: AppendNumber(column, value.number()); break;
+            case JSONValue::Type::Integer: AppendInteger(column, value.integer()); break;
+            case JSONValue::Type::Bool: AppendBool(column, value.boolean()); break;
+            default: {
+                Column& col = Prepare(column, ColumnKind::Mixed);
+                col.values.push_back(value);
+                break;
+            }
+        }
+    }
+
+    void CommitRow() { ++_rows_count; }
+
+    // Перенос строк другого хранилища в конец текущего (сборка из частей)
+    void Append(const ColumnStore& other) {
+        SetColumnsCount(other.ColumnsCount());
+        for (size_t row = 0; row < other.RowsCount(); ++row) {
+            for (size_t column = 0; column < _columns.size(); ++column) {
+                if (column < other.ColumnsCount()) {
+                    other.CopyCell(row, column, *this);
+                } else {
+                    AppendString(column, "", 0);
+                }
+            }
+            CommitRow();
+        }
+    }
+
+    // Запись строк [begin, end) в приёмник, обходя колонки по индексу строки
+    void WriteRows(RowWriter& writer, size_t begin, size_t end) const {
+        end = std::min(end, _rows_count);
+        for (size_t row = begin; row < end; ++row) {
+            writer.BeginRow();
+            for (const auto& col : _columns) {
+                switch (col.kind) {
+                    case ColumnKind::Number:
+                        writer.Number(col.numbers[row]);
+                        break;
+                    case ColumnKind::Integer:
+                        writer.Integer(col.integers[row]);
+                        break;
+                    case ColumnKind::Bool:
+                        writer.Bool(col.flags[row] != 0);
+                        break;
+                    case ColumnKind::String: {
+                        const size_t from = row == 0 ? 0 : col.offsets[row - 1];
+                        writer.String(col.arena.data() + from, col.offsets[row] - from);
+                        break;
+                    }
+                    case ColumnKind::Mixed:
+                        writer.Cell(col.values[row]);
+                        break;
+                    case ColumnKind::Empty:
+                        writer.String("", 0);
+                        break;
+                }
+            }
+            writer.EndRow();
+        }
+    }
+
+    void WriteRows(RowWriter& writer) const { WriteRows(writer, 0, _rows_count); }
+
+    // Объём памяти, занятый данными колонок (без учёта служебных структур)
+    [[nodiscard]] size_t MemoryUsage() const {
+        size_t bytes = 0;
+        for (const auto& col : _columns) {
+            bytes += col.numbers.capacity() * sizeof(double);
+            bytes += col.integers.capacity() * sizeof(int64_t);
+            bytes += col.flags.capacity() * sizeof(uint8_t);
+            bytes += col.arena.capacity();
+            bytes += col.offsets.capacity() * sizeof(size_t);
+            bytes += col.values.capacity() * sizeof(JSONValue);
+        }
+        return bytes;
+    }
+
+private:
+    struct Column {
+        ColumnKind kind = ColumnKind::Empty;
+        std::vector<double> numbers;
+        std::vector<int64_t> integers;
+        std::vector<uint8_t> flags;
+        std::string arena;
+        std::vector<size_t> offsets; // конец строки в арене, по одному на ячейку
+        std::vector<JSONValue> values;
+    };
+
+    std::vector<Column> _columns;
+    size_t _rows_count = 0;
+    size_t _reserved_rows = 0;
+
+    Column& Prepare(const size_t column, const ColumnKind kind) {
+        SetColumnsCount(column + 1);
+        Column& col = _columns[column];
+
+        if (col.kind == ColumnKind::Empty) {
+            col.kind = kind;
+            switch (kind) {
+                case ColumnKind::Number: col.numbers.reserve(_reserved_rows); break;
+                case ColumnKind::Integer: col.integers.reserve(_reserved_rows); break;
+                case ColumnKind::Bool: col.flags.reserve(_reserved_rows); break;
+                case ColumnKind::String: col.offsets.reserve(_reserved_rows); break;
+                case ColumnKind::Mixed: col.values.reserve(_reserved_rows); break;
+                case ColumnKind::Empty: break;
+            }
+        } else if (col.kind != kind && col.kind != ColumnKind::Mixed) {
+            Demote(col);
+        }
+
+        return col;
+    }
+
+    // Колонка получила ячейку другого типа - переводим её в JSONValue на ячейку
+    static void Demote(Column& col) {
+        std::vector<JSONValue> values;
+        switch (col.kind) {
+            case ColumnKind::Number:
+                values.assign(col.numbers.begin(), col.numbers.end());
+                break;
+            case ColumnKind::Integer:
+                for (const auto value : col.integers) values.emplace_back(JSONValue(value));
+                break;
+            case ColumnKind::Bool:
+                for (const auto value : col.flags) values.emplace_back(value != 0);
+                break;
+            case ColumnKind::String: {
+                size_t from = 0;
+                for (const auto to : col.offsets) {
+                    values.emplace_back(col.arena.substr(from, to - from));
+                    from = to;
+                }
+                break;
+            }
+            case ColumnKind::Mixed:
+            case ColumnKind::Empty:
+                break;
+        }
+
+        col = Column{};
+        col.kind = ColumnKind::Mixed;
+        col.values = std::move(values);
+    }
+
+    void CopyCell(const size_t row, const size_t column, ColumnStore& target) const {
+        const Column& col = _columns[column];
+        switch (col.kind) {
+            case ColumnKind::Number:
+                target.AppendNumber(column, col.numbers[row]);
+                break;
+            case ColumnKind::Integer:
+                target.AppendInteger(column, col.integers[row]);
+                break;
+            case ColumnKind::Bool:
+                target.AppendBool(column, col.flags[row] != 0);
+                break;
+            case ColumnKind::String: {
+                const size_t from = row == 0 ? 0 : col.offsets[row - 1];
+                target.AppendString(column, col.arena.data() + from, col.offsets[row] - from);
+                break;
+            }
+            case ColumnKind::Mixed:
+                target.AppendValue(column, col.values[row]);
+                break;
+            case ColumnKind::Empty:
+                target.AppendString(column, "", 0);
+                break;
+        }
+    }
+};
+
+// Запись строк колоночного хранилища через RowWriter
+class ColumnStoreRowWriter final : public RowWriter {
+public:
+    explicit ColumnStoreRowWriter(ColumnStore& store) : _store(store) {}
+
+    void BeginRow() override { _column = 0; }
+
+    void EndRow() override {
+        while (_column < _store.ColumnsCount()) {
+            _store.AppendString(_column++, "", 0);
+        }
+        _store.CommitRow();
+    }
+
+    void String(const char* value, size_t length) override {
+        _store.AppendString(_column++, value, length);
+    }
+
+    void Number(double value) override { _store.AppendNumber(_column++, value); }
+
+    void Integer(int64_t value) override { _store.AppendInteger(_column++, value); }
+
+    void Bool(bool value) override { _store.AppendBool(_column++, value); }
+
+    void Cell(const JSONValue& value) override { _store.AppendValue(_column++, value); }
+
+    using RowWriter::String;
+    using RowWriter::InternedString;
+
+private:
+    ColumnStore& _store;
+    size_t _column = 0;
+};
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstring>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 #include <optional>
+#include <memory>
 #include "ast/Ast.hpp"
+#include "sbxTableBuilder/ColumnStore.hpp"
 
 using namespace ast;
 
@@ -84,6 +90,120 @@ struct TableColumn {
     bool is_sorted = true;              // Доступна ли сортировка (может отсутствовать)
 };
 
+// Запись строк в массив rapidjson::Value (DOM ответа)
+class ValueRowWriter final : public RowWriter {
+public:
+    // rows_count - ожидаемое число строк, массив резервируется сразу (0 - не известно)
+    ValueRowWriter(Value& rows, Document::AllocatorType& allocator, size_t columns_count,
+                   size_t rows_count = 0)
+        : _rows(rows), _allocator(allocator), _columns_count(columns_count) {
+        _rows.SetArray();
+        _rows.Reserve(static_cast<SizeType>(rows_count), _allocator);
+    }
+
+    void BeginRow() override {
+        _row.SetArray();
+        _row.Reserve(static_cast<SizeType>(_columns_count), _allocator);
+    }
+
+    void EndRow() override { _rows.PushBack(_row, _allocator); }
+
+    void String(const char* value, size_t length) override {
+        _row.PushBack(Value(value, static_cast<SizeType>(length), _allocator), _allocator);
+    }
+
+    void Number(double value) override { _row.PushBack(Value(value), _allocator); }
+
+    void Integer(int64_t value) override { _row.PushBack(Value(value), _allocator); }
+
+    void Bool(bool value) override { _row.PushBack(Value(value), _allocator); }
+
+    void Cell(const JSONValue& value) override {
+        Value cell;
+        to_json_value(value, cell, _allocator);
+        _row.PushBack(cell, _allocator);
+    }
+
+    void StaticString(const std::string_view value) override {
+        _row.PushBack(Value(StringRef(value.data(), value.size())), _allocator);
+    }
+
+    // Первое вхождение копируется в аллокатор ответа, следующие ссылаются на эту копию.
+    // Короткие строки rapidjson и так хранит внутри Value без выделения памяти.
+    void InternedString(const char* value, const size_t length) override {
+        if (length <= SHORT_STRING_LENGTH) {
+            String(value, length);
+            return;
+        }
+
+        const auto it = _interned.find(std::string_view(value, length));
+        if (it != _interned.end()) {
+            _row.PushBack(Value(StringRef(it->data(), it->size())), _allocator);
+            return;
+        }
+
+        auto* copy = static_cast<char*>(_allocator.Malloc(length + 1));
+        std::memcpy(copy, value, length);
+        copy[length] = '\0';
+
+        _interned.emplace(copy, length);
+        _row.PushBack(Value(StringRef(copy, length)), _allocator);
+    }
+
+    using RowWriter::String;
+    using RowWriter::InternedString;
+
+private:
+    // Длина строки, которую rapidjson (64 бит) размещает внутри Value
+    static constexpr size_t SHORT_STRING_LENGTH = 13;
+
+    Value& _rows;
+    Document::AllocatorType& _allocator;
+    size_t _columns_count;
+    Value _row;
+    std::unordered_set<std::string_view> _interned; // указывают на копии в аллокаторе ответа
+};
+
+// Запись строк через SAX-интерфейс rapidjson::Writer
+template <typename JsonWriter>
+class StreamRowWriter final : public RowWriter {
+public:
+    explicit StreamRowWriter(JsonWriter& writer) : _writer(writer) {}
+
+    void BeginRow() override { _writer.StartArray(); }
+
+    void EndRow() override { _writer.EndArray(); }
+
+    void String(const char* value, size_t length) override {
+        _writer.String(value, static_cast<SizeType>(length));
+    }
+
+    void Number(double value) override { _writer.Double(value); }
+
+    void Integer(int64_t value) override { _writer.Int64(value); }
+
+    void Bool(bool value) override { _writer.Bool(value); }
+
+    void Cell(const JSONValue& value) override {
+        Document document;
+        to_json_value(value, document, document.GetAllocator());
+        document.Accept(_writer);
+    }
+
+    using RowWriter::String;
+    using RowWriter::InternedString;
+
+private:
+    JsonWriter& _writer;
+};
+
+// Колонки, не зависящие от запроса: собираются один раз на процесс (TableBuilder::ShareColumns)
+// и подключаются к билдерам отчётов без копирования описаний (TableBuilder::SetColumns)
+struct SharedColumns {
+    std::vector<std::string> keys;              // Ключи колонок в порядке отображения
+    std::shared_ptr<const JSONValue> structure; // Описания колонок (объект structure)
+};
+
 // Основной класс для пошаговой сборки JSON-описания таблицы
 class TableBuilder {
 public:
@@ -92,6 +212,7 @@ public:
 
     void AddColumn(const TableColumn& column) {
         _column_order_by_keys.push_back(column.key);
+        _rows->SetColumnsCount(_column_order_by_keys.size());
 
         JSONObject column_obj;
         column_obj["name"] = column.language_token;
@@ -103,18 +224,57 @@ public:
             column_obj["filter"] = ConvertFilterToJson(*column.filter);
         }
 
-        _structure[column.key] = std::move(column_obj);
+        _structure[String(column.key)] = std::move(column_obj);
     }
 
-    void AddRow(const std::vector<JSONValue>& row_values) {
-        JSONArray json_row;
-        json_row.reserve(row_values.size());
+    // Забирает добавленные колонки для повторного использования. Описания должны пережить
+    // арену отчёта: билдер заполняется под ast::ResourceScope(std::pmr::new_delete_resource())
+    [[nodiscard]] SharedColumns ShareColumns() && {
+        return {std::move(_column_order_by_keys),
+                std::make_shared<const JSONValue>(std::move(_structure))};
+    }
 
-        for (const auto& val : row_values) {
-            json_row.push_back(val);
-        }
+    // Колонки, собранные ранее через ShareColumns, вместо вызовов AddColumn
+    void SetColumns(const SharedColumns& columns) {
+        _column_order_by_keys = columns.keys;
+        _rows->SetColumnsCount(_column_order_by_keys.size());
+        _shared_structure = columns.structure;
+    }
 
-        _rows.push_back(std::move(json_row));
+    void AddRow(const std::vector<JSONValue>& row_values) { _rows->AddRow(row_values); }
+
+    // Добавление строк через RowWriter сразу в колоночное хранилище, без JSONValue на ячейку
+    template <typename Producer>
+    void AddRows(Producer&& producer) {
+        ColumnStoreRowWriter row_writer(*_rows);
+        producer(row_writer);
+    }
+
+    void ReserveRows(size_t rows_count) { _rows->Reserve(rows_count); }
+
+    // Генератор строк для потокового режима: вызывается в момент сериализации
+    using RowProducer = std::function<void(RowWriter&)>;
+
+    // Потоковый режим: строки не накапливаются в билдере, а пишутся генератором прямо
+    // в ответ. Всё, что захватывает генератор, должно жить до окончания сериализации.
+    // rows_count - число строк генератора, если известно: массив строк резервируется заранее.
+    void StreamRows(RowProducer producer, size_t rows_count = 0) {
+        _row_producer = std::move(producer);
+        _streamed_rows_count = rows_count;
+    }
+
+    // Запись строк (накопленных или потоковых) через rapidjson::Writer
+    template <typename JsonWriter>
+    void WriteRows(JsonWriter& writer) const {
+        writer.StartArray();
+        if (_row_producer) {
+            StreamRowWriter<JsonWriter> row_writer(writer);
+            _row_producer(row_writer);
+        } else {
+            StreamRowWriter<JsonWriter> row_writer(writer);
+            _rows->WriteRows(row_writer);
+        }
+        writer.EndArray();
     }
 
     void SetIdColumn(const std::string& id_column) { _id_column = id_column; }
@@ -135,58 +295,102 @@ public:
 
     void SetLimit(int limit) { _limit = limit; }
 
+    // Серверная пагинация: смещение окна и общее число строк до пагинации
+    void SetPagination(size_t offset, size_t total_rows) { _pagination = {offset, total_rows}; }
+
+    // Курсор для запроса следующей страницы (keyset)
+    void SetNextCursor(const JSONValue& cursor) { _next_cursor = cursor; }
+
     void SetTotalDataTitle(const std::string& title) { _total_data_title = title; }
 
-    void SetTotalData(const JSONArray& total_data) { _total_data = total_data; }
+    void SetTotalData(JSONArray total_data) { _total_data = std::move(total_data); }
+
+    [[nodiscard]] JSONObject CreateTableProps() const& { return MakeTableProps(*this); }
+
+    // Билдер больше не нужен: структура, итоги и генератор строк переносятся без копирования
+    [[nodiscard]] JSONObject CreateTableProps() && { return MakeTableProps(std::move(*this)); }
 
-    [[nodiscard]] JSONObject CreateTableProps() const {
+private:
+    template <typename Self>
+    static JSONObject MakeTableProps(Self&& self) {
         JSONObject table_props;
-        table_props["name"] = _table_name;
-        table_props["idCol"] = _id_column;
-        table_props["orderBy"] = JSONArray{_order_by.first, _order_by.second};
-        table_props["autoSave"] = _is_auto_save_enabled;
-        table_props["showRefreshBtn"] = _is_refresh_button_enabled;
-        table_props["showBookmarksBtn"] = _is_bookmarks_button_enabled;
-        table_props["showExportBtn"] = _is_export_button_enabled;
-        table_props["showTotal"] = _is_total_row_enabled;
-        table_props["totalDataTitle"] = _total_data_title;
-        table_props["limit"] = static_cast<double>(_limit);
-
-        if (!_total_data.empty()) {
-            table_props["totalData"] = _total_data;
+        table_props["name"] = self._table_name;
+        table_props["idCol"] = self._id_column;
+        table_props["orderBy"] = JSONArray{self._order_by.first, self._order_by.second};
+        table_props["autoSave"] = self._is_auto_save_enabled;
+        table_props["showRefreshBtn"] = self._is_refresh_button_enabled;
+        table_props["showBookmarksBtn"] = self._is_bookmarks_button_enabled;
+        table_props["showExportBtn"] = self._is_export_button_enabled;
+        table_props["showTotal"] = self._is_total_row_enabled;
+        table_props["totalDataTitle"] = self._total_data_title;
+        table_props["limit"] = static_cast<double>(self._limit);
+
+        if (self._pagination) {
+            table_props["offset"] = static_cast<double>(self._pagination->first);
+            table_props["totalRows"] = static_cast<double>(self._pagination->second);
         }
 
-        JSONObject data_obj;
-        JSONArray json_rows;
-        json_rows.reserve(_rows.size());
+        if (self._next_cursor) {
+            table_props["nextCursor"] = *self._next_cursor;
+        }
 
-        for (const auto& row : _rows) {
-            json_rows.emplace_back(row);
+        if (!self._total_data.empty()) {
+            table_props["totalData"] = std::forward<Self>(self)._total_data;
         }
 
-        data_obj["rows"] = std::move(json_rows);
+        JSONObject data_obj;
+
+        if (self._row_producer) {
+            data_obj["rows"] = JSONDeferred{
+                [producer = std::forward<Self>(self)._row_producer,
+                 columns_count = self._column_order_by_keys.size(),
+                 rows_count = self._streamed_rows_count](Value& out,
+                                                         Document::AllocatorType& allocator) {
+                    ValueRowWriter row_writer(out, allocator, columns_count, rows_count);
+                    producer(row_writer);
+                }};
+        } else {
+            // Строки сериализуются из колонок в момент to_json, снимок - по числу строк
+            data_obj["rows"] = JSONDeferred{
+                [rows = std::shared_ptr<const ColumnStore>(self._rows),
+                 rows_count = self._rows->RowsCount(),
+                 columns_count = self._column_order_by_keys.size()](Value& out,
+                                                                    Document::AllocatorType& allocator) {
+                    ValueRowWriter row_writer(out, allocator, columns_count, rows_count);
+                    rows->WriteRows(row_writer, 0, rows_count);
+                }};
+        }
 
 
         JSONArray structure_keys;
-        structure_keys.reserve(_column_order_by_keys.size());
+        structure_keys.reserve(self._column_order_by_keys.size());
 
-        for (const auto& key : _column_order_by_keys) {
+        for (const auto& key : self._column_order_by_keys) {
             structure_keys.emplace_back(key);
         }
 
         data_obj["structure"] = std::move(structure_keys);
         table_props["data"] = std::move(data_obj);
-        table_props["structure"] = _structure;
+        if (self._shared_structure) {
+            table_props["structure"] = JSONDeferred{
+                [structure = self._shared_structure](Value& out, Document::AllocatorType& allocator) {
+                    to_json_value(*structure, out, allocator);
+                }};
+        } else {
+            table_props["structure"] = std::forward<Self>(self)._structure;
+        }
 
         return table_props;
     }
 
-private:
     std::string _table_name;
     std::string _id_column;
     std::vector<std::string> _column_order_by_keys;
-    std::vector<JSONArray> _rows;
+    std::shared_ptr<ColumnStore> _rows = std::make_shared<ColumnStore>();
+    RowProducer _row_producer;
+    size_t _streamed_rows_count = 0;
     JSONObject _structure;
+    std::shared_ptr<const JSONValue> _shared_structure;
     std::pair<std::string, std::string> _order_by{"id", "DESC"};
     bool _is_auto_save_enabled = false;
     bool _is_refresh_button_enabled = true;
@@ -194,6 +398,8 @@ private:
     bool _is_export_button_enabled = true;
     bool _is_total_row_enabled = false;
     int _limit = 20;
+    std::optional<std::pair<size_t, size_t>> _pagination;
+    std::optional<JSONValue> _next_cursor;
     std::string _total_data_title;
     JSONArray _total_data;
 
@@ -230,34 +436,34 @@ private:
         return json_object;
     }
 
-    static std::string ConvertFilterTypeToString(const FilterType filter_type) {
+    static JSONStaticString ConvertFilterTypeToString(const FilterType filter_type) {
         switch (filter_type) {
-            case FilterType::Search: return "search";
-            case FilterType::Select: return "select";
-            case FilterType::Date: return "date";
-            case FilterType::DateTime: return "date-time";
-            case FilterType::DateTimeSec: return "date-time-sec";
-            case FilterType::DateInput: return "date-input";
-            case FilterType::DateTimeInput: return "date-time-input";
-            case FilterType::DateTimeSecInput: return "date-time-sec-input";
+            case FilterType::Search: return {"search"};
+            case FilterType::Select: return {"select"};
+            case FilterType::Date: return {"date"};
+            case FilterType::DateTime: return {"date-time"};
+            case FilterType::DateTimeSec: return {"date-time-sec"};
+            case FilterType::DateInput: return {"date-input"};
+            case FilterType::DateTimeInput: return {"date-time-input"};
+            case FilterType::DateTimeSecInput: return {"date-time-sec-input"};
         }
-        return "search";
+        return {"search"};
     }
 
-    static std::string ConvertSearchTypeToString(const SearchType search_type) {
+    static JSONStaticString ConvertSearchTypeToString(const SearchType search_type) {
         switch (search_type) {
-            case SearchType::Like: return "like";
-            case SearchType::Equal: return "equal";
-            case SearchType::NotEqual: return "not_equal";
-            case SearchType::Between: return "between";
-            case SearchType::Outside: return "outside";
-            case SearchType::Below: return "below";
-            case SearchType::BelowOrEqual: return "below_or_equal";
-            case SearchType::Above: return "above";
-            case SearchType::AboveOrEqual: return "above_or_equal";
-            case SearchType::Select: return "select";
-            case SearchType::SelectExcept: return "select_except";
+            case SearchType::Like: return {"like"};
+            case SearchType::Equal: return {"equal"};
+            case SearchType::NotEqual: return {"not_equal"};
+            case SearchType::Between: return {"between"};
+            case SearchType::Outside: return {"outside"};
+            case SearchType::Below: return {"below"};
+            case SearchType::BelowOrEqual: return {"below_or_equal"};
+            case SearchType::Above: return {"above"};
+            case SearchType::AboveOrEqual: return {"above_or_equal"};
+            case SearchType::Select: return {"select"};
+            case SearchType::SelectExcept: return {"select_except"};
         }
-        return "like";
+        return {"like"};
     }
 };
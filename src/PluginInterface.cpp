@@ -2,6 +2,17 @@
 
 #include <iomanip>
 
+namespace {
+    // Static part of the report tree, shared by every report
+    const SharedNode& GetReportTitle() {
+        static const SharedNode title = [] {
+            const ResourceScope heap(std::pmr::new_delete_resource());
+            return share(h1({text("Pending Trades Report")}));
+        }();
+        return title;
+    }
+} // namespace
+
 extern "C" void AboutReport(rapidjson::Value&                   request,
                             rapidjson::Value&                   response,
                             rapidjson::Document::AllocatorType& allocator,
@@ -10,47 +21,199 @@ extern "C" void AboutReport(rapidjson::Value&                   request,
     response.AddMember("name", Value().SetString("Pending Trades report", allocator), allocator);
     response.AddMember("description",
                        Value().SetString("Summary data on pending trades executed by a selected "
-                                         "group of traders over a specified day. "
+                                         "group of traders over a specified period. "
                                          "Includes date, symbol, price, profit, volume, s / l, t / "
                                          "p, commission, swap and account information.",
                                          allocator),
                        allocator);
-    response.AddMember("type", static_cast<int>(ReportType::DailyGroup), allocator);
+    response.AddMember("type", static_cast<int>(ReportType::RangeGroup), allocator);
     response.AddMember("key", Value().SetString("PENDING_TRADES_REPORT", allocator), allocator);
 }
 
-extern "C" void DestroyReport() {}
+extern "C" void DestroyReport() {
+    report::ResultCache::Instance().Clear();
+    report::RateCache::Instance().Clear();
+    report::PendingTradesView::Instance().Clear();
+    report::PerfHistograms::Instance().Clear();
+    report::WorkerPool::Instance().Stop();
+}
+
+extern "C" void OnTradeEvent(const int                event_type,
+                             const int                record_type,
+                             const ReportTradeRecord& trade) {
+    if (event_type == EV_TYPE_TRADE) {
+        report::PendingTradesView::Instance().OnTradeEvent(record_type, trade);
+    }
+}
 
 extern "C" void CreateReport(rapidjson::Value&                   request,
                              rapidjson::Value&                   response,
                              rapidjson::Document::AllocatorType& allocator,
                              ReportServerInterface*              server) {
-    std::string group_mask;
-    int         from;
-    int         to;
+    // AST values of this report are bump-allocated and released together; declared first so
+    // that it outlives every node, props object and table builder below
+    ast::ArenaScope arena;
 
-    if (request.HasMember("group") && request["group"].IsString()) {
-        group_mask = request["group"].GetString();
-    }
-    if (request.HasMember("from") && request["from"].IsNumber()) {
-        from = request["from"].GetInt();
+    // Opt-in instrumentation, see PerfTrace
+    report::PerfTrace perf(request, allocator);
+    perf.Enter(report::PerfPhase::Request);
+
+    // Server calls are counted through a forwarding wrapper only while tracing
+    report::CountingServer counting_server(server);
+    if (perf.Enabled()) {
+        server = &counting_server;
     }
-    if (request.HasMember("to") && request["to"].IsNumber()) {
-        to = request["to"].GetInt();
+
+    const report::ReportRequest report_request = report::ReportRequest::Parse(request);
+    const std::string&          group_mask     = report_request.group_mask;
+
+    // Cache
+    perf.Enter(report::PerfPhase::CacheLookup);
+    std::string cache_key;
+    if (report_request.use_cache) {
+        cache_key = report_request.GetCacheKey();
+        if (report::ResultCache::Instance().Get(cache_key, response, allocator)) {
+            perf.Add(report::PerfCounter::CacheHits, 1);
+            perf.Finish(response, allocator);
+            return;
+        }
     }
 
-    std::unordered_map<std::string, double> total_volume_map;
-    std::vector<ReportTradeRecord>          trades_vector;
-    std::vector<ReportGroupRecord>          groups_vector;
+    // Pending trades: the live view when the host feeds trade events, the server otherwise. The
+    // server is queried by day partitions of the range, in parallel; enrichment below runs once
+    // over the merged rows.
+    perf.Enter(report::PerfPhase::FetchTrades);
+    report::PendingTradesView::Snapshot trades =
+        report::PendingTradesView::Instance().Query(server, group_mask);
+    const bool is_from_view = trades != nullptr;
+
+    std::vector<ReportGroupRecord> groups_vector;
+    bool                           is_fetched = true;
 
     try {
-        server->GetPendingTradesByGroup(group_mask, from, to, &trades_vector);
+        if (!is_from_view) {
+            auto fetched_trades = std::make_shared<std::vector<ReportTradeRecord>>();
+            trades              = fetched_trades;
+
+            // No more partitions than workers: every call of the range is in flight at once
+            const std::vector<report::TimePartition> partitions =
+                report::SplitIntoDays(report_request.from,
+                                      report_request.to,
+                                      report::WorkerPool::Instance().WorkersCount());
+            perf.Add(report::PerfCounter::FetchPartitions, partitions.size());
+            is_fetched =
+                report::FetchPendingTrades(server, group_mask, partitions, *fetched_trades);
+        }
+        perf.Enter(report::PerfPhase::FetchGroups);
         server->GetAllGroups(&groups_vector);
     } catch (const std::exception& e) {
         std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+        is_fetched = false;
+    }
+
+    const std::vector<ReportTradeRecord>& trades_vector = *trades;
+    perf.Add(report::PerfCounter::RowsFetched, trades_vector.size());
+    perf.Add(report::PerfCounter::ViewHits, is_from_view ? 1 : 0);
+
+    // Dimensions
+    perf.Enter(report::PerfPhase::Setup);
+    report::GroupIndex group_index;
+    group_index.Build(groups_vector);
+
+    // Filters run before enrichment: rows dropped here are never resolved or formatted. Money
+    // predicates compare converted values and wait for the rates.
+    perf.Enter(report::PerfPhase::Filter);
+    const report::RowFilter row_filter(report_request.filters, true);
+
+    std::vector<uint32_t> rows;
+    rows.reserve(trades_vector.size());
+    for (uint32_t row = 0; row < trades_vector.size(); ++row) {
+        // The view holds every open time, the server applies the range itself
+        if (!is_from_view || (trades_vector[row].open_time >= report_request.from &&
+                              trades_vector[row].open_time <= report_request.to)) {
+            rows.push_back(row);
+        }
+    }
+    row_filter.Apply(report::RowFilter::Stage::Trade, trades_vector, rows);
+
+    perf.Enter(report::PerfPhase::Accounts);
+    report::AccountIndex account_index;
+    account_index.Build(server, group_mask, trades_vector, rows);
+
+    // Conversion rates: one per (currency, side) of the rows, cached across reports
+    perf.Enter(report::PerfPhase::Rates);
+    report::ConversionMatrix conversion(group_index, report_request.currency);
+    perf.Add(report::PerfCounter::RateCacheHits,
+             conversion.Build(server, trades_vector, rows, account_index));
+
+    perf.Enter(report::PerfPhase::Filter);
+    row_filter.Apply(report::RowFilter::Stage::Account,
+                     trades_vector,
+                     rows,
+                     &account_index,
+                     &group_index,
+                     &conversion);
+
+    // Enrichment, formatting and totals run in row chunks on the worker pool
+    const report::RowPipeline row_pipeline(trades_vector, account_index, group_index, &conversion);
+
+    // The export carries rows only, totals are computed for the table
+    perf.Enter(report::PerfPhase::Totals);
+    const bool                   is_export = report_request.format != report::OutputFormat::Ui;
+    const report::CurrencyTotals totals =
+        is_export ? report::CurrencyTotals() : row_pipeline.Totals(rows);
+
+    // Window: totals above cover the whole filtered set, only the requested rows are materialized
+    perf.Enter(report::PerfPhase::Sort);
+    const size_t            total_rows = rows.size();
+    const report::RowSorter sorter(trades_vector, account_index, group_index, &conversion);
+    const report::RowWindow window =
+        report::SelectWindow(trades_vector, std::move(rows), report_request, sorter);
+    perf.Add(report::PerfCounter::RowsFiltered, total_rows);
+    perf.Add(report::PerfCounter::RowsEmitted, window.rows.size());
+
+    // Rows go through a RowWriter: streamed into the table while the response is serialized,
+    // or straight into the export
+    const auto write_rows = [&](RowWriter& writer) { row_pipeline.Write(window.rows, writer); };
+
+    // Exports bypass the table and the UI tree: CSV rows are written as they are formatted,
+    // columnar files are built from the records directly
+    if (is_export) {
+        perf.Enter(report::PerfPhase::Export);
+        if (report_request.format == report::OutputFormat::Columnar) {
+            report::ExportColumnar(trades_vector,
+                                   window.rows,
+                                   account_index,
+                                   group_index,
+                                   response,
+                                   allocator,
+                                   &conversion);
+        } else {
+            std::vector<std::string_view> header;
+            header.reserve(report::COLUMN_DEFINITIONS.size());
+            for (const auto& column : report::COLUMN_DEFINITIONS) {
+                header.push_back(column.key);
+            }
+
+            // Only the in-memory content is pre-sized, a file export skips the sample
+            const size_t expected_bytes = report_request.export_to_file
+                                              ? 0
+                                              : row_pipeline.Estimate(window.rows).csv_bytes;
+            report::ExportCsv(header,
+                              write_rows,
+                              report_request.export_to_file,
+                              expected_bytes,
+                              response,
+                              allocator);
+        }
+
+        perf.Add(report::PerfCounter::ServerCalls, counting_server.GetCallCount());
+        perf.Finish(response, allocator);
+        return;
     }
 
     // Main table
+    perf.Enter(report::PerfPhase::Setup);
     TableBuilder table_builder("PendingTradesReportTable");
 
     // Main table props
@@ -63,85 +226,62 @@ extern "C" void CreateReport(rapidjson::Value&                   request,
     table_builder.EnableTotal(true);
     table_builder.SetTotalDataTitle("TOTAL");
 
-    // Filters
-    FilterConfig search_filter;
-    search_filter.type = FilterType::Search;
+    // Columns
+    table_builder.SetColumns(report::GetTableColumns());
 
-    FilterConfig date_time_filter;
-    date_time_filter.type = FilterType::DateTime;
+    const std::vector<report::SortKey> sort = report_request.GetEffectiveSort();
+    if (!sort.empty()) {
+        table_builder.SetOrderBy(sort.front().column, sort.front().descending ? "DESC" : "ASC");
+    }
 
-    // Columns
-    table_builder.AddColumn({"order", "ORDER", 1, search_filter});
-    table_builder.AddColumn({"login", "LOGIN", 2, search_filter});
-    table_builder.AddColumn({"name", "NAME", 3, search_filter});
-    table_builder.AddColumn({"open_time", "OPEN_TIME", 4, date_time_filter});
-    table_builder.AddColumn({"type", "TYPE", 5, search_filter});
-    table_builder.AddColumn({"symbol", "SYMBOL", 6, search_filter});
-    table_builder.AddColumn({"volume", "VOLUME", 7, search_filter});
-    table_builder.AddColumn({"open_price", "OPEN_PRICE", 8, search_filter});
-    table_builder.AddColumn({"sl", "S / L", 9, search_filter});
-    table_builder.AddColumn({"tp", "T / P", 10, search_filter});
-    table_builder.AddColumn({"storage", "SWAP", 11, search_filter});
-    table_builder.AddColumn({"profit", "AMOUNT", 12, search_filter});
-    table_builder.AddColumn({"comment", "COMMENT", 13, search_filter});
-    table_builder.AddColumn({"currency", "CURRENCY", 14, search_filter});
-    table_builder.AddColumn({"group", "GROUP", 15, search_filter});
-
-    for (const auto& trade : trades_vector) {
-        ReportAccountRecord account;
-
-        try {
-            server->GetAccountByLogin(trade.login, &account);
-        } catch (const std::exception& e) {
-            std::cerr << "[OpenTradesReportInterface]: " << e.what() << std::endl;
+    if (report_request.IsPaginated()) {
+        table_builder.SetPagination(report_request.offset, total_rows);
+        if (report_request.limit) {
+            table_builder.SetLimit(static_cast<int>(*report_request.limit));
+        }
+        if (window.has_more && !window.rows.empty() && sort.front().column == "order") {
+            table_builder.SetNextCursor(
+                static_cast<double>(trades_vector[window.rows.back()].order));
         }
-
-        const std::string currency   = utils::GetGroupCurrencyByName(groups_vector, account.group);
-        double            multiplier = 1;
-
-        total_volume_map[currency] += trade.volume;
-
-        // Conversion disabled
-        // if (currency != "USD") {
-        //     try {
-        //         server->CalculateConvertRateByCurrency(
-        //             currency, "USD", static_cast<int>(trade.cmd), &multiplier);
-        //     } catch (const std::exception& e) {
-        //         std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
-        //     }
-        // }
-
-        table_builder.AddRow({utils::TruncateDouble(trade.order, 0),
-                              utils::TruncateDouble(trade.login, 0),
-                              account.name,
-                              utils::FormatTimestampToString(trade.open_time),
-                              utils::ConvertCmdToString(static_cast<int>(trade.cmd)),
-                              trade.symbol,
-                              utils::TruncateDouble(trade.volume / 100.0, 2),
-                              utils::TruncateDouble(trade.open_price * multiplier, 2),
-                              utils::TruncateDouble(trade.sl * multiplier, 2),
-                              utils::TruncateDouble(trade.tp * multiplier, 2),
-                              utils::TruncateDouble(trade.storage * multiplier, 2),
-                              utils::TruncateDouble(trade.profit * multiplier, 2),
-                              trade.comment,
-                              currency,
-                              account.group});
     }
 
+    table_builder.StreamRows(write_rows, window.rows.size());
+
     // Total row
+    perf.Enter(report::PerfPhase::TableProps);
     JSONArray totals_array;
-    for (const auto& [currency, total_volume] : total_volume_map) {
-        totals_array.emplace_back(JSONObject{
-            {"volume", utils::TruncateDouble(total_volume / 100.0, 2)}, {"currency", currency}});
+    for (report::CurrencyId id = 0; id < totals.volume.size(); ++id) {
+        if (!totals.has_trades[id]) {
+            continue;
+        }
+        totals_array.emplace_back(
+            JSONObject{{"volume", utils::TruncateDouble(totals.volume[id] / 100.0, 2)},
+                       {"currency", group_index.GetCurrency(id)}});
     }
 
-    table_builder.SetTotalData(totals_array);
+    table_builder.SetTotalData(std::move(totals_array));
 
-    const JSONObject table_props = table_builder.CreateTableProps();
-    const Node       table_node  = Table({}, table_props);
+    // Moved through to the report tree: the table props are never copied
+    Node table_node = Table({}, std::move(table_builder).CreateTableProps());
 
     // Total report
-    const Node report = Column({h1({text("Pending Trades Report")}), table_node});
+    perf.Enter(report::PerfPhase::CreateUI);
+    const Node report = Column(nodes(ref(GetReportTitle()), std::move(table_node)));
+
+    // Size of the response, for the cache pool (the allocator walks its chunks to tell)
+    const size_t allocator_size = report_request.use_cache ? allocator.Size() : 0;
 
+    // Rows are formatted here, while the deferred table data is serialized
     utils::CreateUI(report, response, allocator);
+
+    // Partial results of a failed fetch are not cached; a failed row chunk throws out of the
+    // pipeline before this point
+    perf.Enter(report::PerfPhase::CachePut);
+    if (report_request.use_cache && is_fetched) {
+        report::ResultCache::Instance().Put(cache_key, response, allocator.Size() - allocator_size);
+    }
+
+    // Added after the cache put, a cached response never carries a stale trace
+    perf.Add(report::PerfCounter::ServerCalls, counting_server.GetCallCount());
+    perf.Finish(response, allocator);
 }
@@ -0,0 +1,78 @@
+#include "AccountIndex.h"
+
+#include <iostream>
+
+namespace report {
+    const ReportAccountRecord AccountIndex::_empty_account{};
+
+    void AccountIndex::Build(ReportServerInterface*                server,
+                             const std::string&                    group_mask,
+                             const std::vector<ReportTradeRecord>& trades) {
+        std::unordered_set<int> logins;
+        logins.reserve(trades.size());
+        for (const auto& trade : trades) {
+            logins.insert(trade.login);
+        }
+
+        Build(server, group_mask, std::move(logins));
+    }
+
+    void AccountIndex::Build(ReportServerInterface*                server,
+                             const std::string&                    group_mask,
+                             const std::vector<ReportTradeRecord>& trades,
+                             const std::vector<uint32_t>&          rows) {
+        std::unordered_set<int> logins;
+        logins.reserve(rows.size());
+        for (const uint32_t row : rows) {
+            logins.insert(trades[row].login);
+        }
+
+        Build(server, group_mask, std::move(logins));
+    }
+
+    void AccountIndex::Build(ReportServerInterface*  server,
+                             const std::string&      group_mask,
+                             std::unordered_set<int> logins) {
+        _accounts.clear();
+        _index_by_login.clear();
+
+        if (logins.empty()) {
+            return;
+        }
+
+        _index_by_login.reserve(logins.size());
+
+        try {
+            server->GetAccountsByGroup(group_mask, &_accounts);
+        } catch (const std::exception& e) {
+            std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+        }
+
+        for (size_t i = 0; i < _accounts.size(); ++i) {
+            const int login = _accounts[i].login;
+            if (logins.erase(login) > 0) {
+                _index_by_login.emplace(login, i);
+            }
+        }
+
+        // Logins outside the bulk result (moved between groups, mask mismatch) fall back to
+        // per-login lookups. A failed lookup still caches an empty record, as the row loop used to.
+        for (const int login : logins) {
+            ReportAccountRecord account;
+
+            try {
+                server->GetAccountByLogin(login, &account);
+            } catch (const std::exception& e) {
+                std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+            }
+
+            _index_by_login.emplace(login, _accounts.size());
+            _accounts.push_back(std::move(account));
+        }
+    }
+
+    const ReportAccountRecord& AccountIndex::Find(const int login) const {
+        const auto it = _index_by_login.find(login);
+        return it != _index_by_login.end() ? _accounts[it->second] : _empty_account;
+    }
+} // namespace report
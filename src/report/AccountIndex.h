@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Login-keyed account lookup built once per report. Accounts are fetched in bulk by the
+    // report's group mask; only logins missing from the bulk result are resolved one by one.
+    class AccountIndex {
+    public:
+        void Build(ReportServerInterface*                server,
+                   const std::string&                    group_mask,
+                   const std::vector<ReportTradeRecord>& trades);
+
+        // Resolves only the logins of the selected rows (indices into trades)
+        void Build(ReportServerInterface*                server,
+                   const std::string&                    group_mask,
+                   const std::vector<ReportTradeRecord>& trades,
+                   const std::vector<uint32_t>&          rows);
+
+        // Returns an empty record when the login could not be resolved.
+        [[nodiscard]] const ReportAccountRecord& Find(int login) const;
+
+        [[nodiscard]] size_t Size() const { return _index_by_login.size(); }
+
+    private:
+        void Build(ReportServerInterface* server,
+                   const std::string&     group_mask,
+                   std::unordered_set<int> logins);
+
+        std::vector<ReportAccountRecord>  _accounts;
+        std::unordered_map<int, size_t>   _index_by_login;
+        static const ReportAccountRecord _empty_account;
+    };
+} // namespace report
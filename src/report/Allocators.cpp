@@ -0,0 +1,52 @@
+#include "Allocators.h"
+
+#include <memory>
+
+namespace report {
+    namespace {
+        thread_local uint64_t pool_chunks_count = 0;
+
+        // First chunk of the scratch pools of this thread, allocated on first use
+        struct FirstChunk {
+            std::unique_ptr<char[]> buffer;
+            bool                    is_used = false;
+        };
+
+        thread_local FirstChunk first_chunk;
+    } // namespace
+
+    uint64_t GetPoolChunksCount() { return pool_chunks_count; }
+
+    void AddPoolChunks(const uint64_t count) { pool_chunks_count += count; }
+
+    ScratchPool::ScratchPool() {
+        if (first_chunk.is_used) {
+            _allocator.emplace(FIRST_CHUNK_SIZE);
+            return;
+        }
+
+        if (!first_chunk.buffer) {
+            first_chunk.buffer = std::make_unique<char[]>(FIRST_CHUNK_SIZE);
+            AddPoolChunks(1);
+        }
+        first_chunk.is_used = true;
+        _owns_first_chunk   = true;
+        _allocator.emplace(first_chunk.buffer.get(), FIRST_CHUNK_SIZE, FIRST_CHUNK_SIZE);
+    }
+
+    ScratchPool::~ScratchPool() {
+        // Chunks beyond the first one; the first chunk's header is not part of the capacity
+        const size_t first_capacity =
+            _owns_first_chunk ? FIRST_CHUNK_SIZE - sizeof(size_t) * 2 - sizeof(void*) : 0;
+        const size_t capacity = _allocator->Capacity();
+        if (capacity > first_capacity) {
+            AddPoolChunks(AllocatorChunksCount(capacity - first_capacity, FIRST_CHUNK_SIZE));
+        }
+
+        // Frees the added chunks and empties the first one
+        _allocator.reset();
+        if (_owns_first_chunk) {
+            first_chunk.is_used = false;
+        }
+    }
+} // namespace report
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <rapidjson/document.h>
+
+namespace report {
+    // Pools owned by the plugin have the type of the response allocator, so their values can be
+    // serialized by the same code and copied into the response
+    using PoolAllocator = rapidjson::Document::AllocatorType;
+
+    inline constexpr size_t DEFAULT_CHUNK_SIZE = RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY;
+
+    // Chunks a pool growing by `capacity` bytes allocated. MemoryPoolAllocator does not expose
+    // its chunk list: a chunk sized for a single value larger than `chunk_size` is counted as
+    // the chunks it spans.
+    inline uint64_t AllocatorChunksCount(const size_t capacity,
+                                         const size_t chunk_size = DEFAULT_CHUNK_SIZE) {
+        return (capacity + chunk_size - 1) / chunk_size;
+    }
+
+    // Chunks allocated by the plugin-owned pools on this thread so far (see PerfTrace)
+    uint64_t GetPoolChunksCount();
+
+    void AddPoolChunks(uint64_t count);
+
+    // Pool for intermediate documents (JSON text of a cell, scratch copies). Its first chunk
+    // belongs to the thread and is reused by the next scratch pool, so a small intermediate
+    // document allocates nothing; further chunks are freed with the pool. A scratch pool opened
+    // while another is alive on the same thread starts without the first chunk.
+    class ScratchPool {
+    public:
+        static constexpr size_t FIRST_CHUNK_SIZE = 256 * 1024;
+
+        ScratchPool();
+        ~ScratchPool();
+
+        ScratchPool(const ScratchPool&)            = delete;
+        ScratchPool& operator=(const ScratchPool&) = delete;
+
+        PoolAllocator& Get() { return *_allocator; }
+
+    private:
+        bool                         _owns_first_chunk = false;
+        std::optional<PoolAllocator> _allocator;
+    };
+
+    // Output a report is expected to produce, from the row count and the average row length of
+    // a sample. Used to pre-size arrays and buffers, never as a limit.
+    struct OutputEstimate {
+        size_t rows_count = 0;
+        size_t csv_bytes  = 0; // CSV text of the rows, 0 when not sampled
+    };
+} // namespace report
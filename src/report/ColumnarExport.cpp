@@ -0,0 +1,426 @@
+#include "ColumnarExport.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CsvExport.h"
+#include "utils/Utils.h"
+
+namespace report {
+    namespace {
+        static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                      "columnar buffers are written in host order and must be little-endian");
+
+        constexpr size_t Align(const size_t offset) {
+            return (offset + columnar::ALIGNMENT - 1) / columnar::ALIGNMENT * columnar::ALIGNMENT;
+        }
+
+        template <typename T>
+        void AppendBytes(std::string& buffer, const T* values, const size_t count) {
+            buffer.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+        }
+
+        bool WritePadding(std::FILE* file, const size_t count) {
+            static constexpr char zeros[columnar::ALIGNMENT] = {};
+            return count == 0 || std::fwrite(zeros, 1, count, file) == count;
+        }
+    } // namespace
+
+    ColumnarWriter::Column& ColumnarWriter::Add(const std::string_view name,
+                                                const columnar::ColumnType type) {
+        Column& column     = _columns.emplace_back();
+        column.header.type = type;
+        std::memcpy(column.header.name,
+                    name.data(),
+                    std::min(name.size(), columnar::COLUMN_NAME_SIZE - 1));
+        return column;
+    }
+
+    void ColumnarWriter::AppendStrings(const std::vector<std::string_view>& strings,
+                                       Column&                              column) {
+        std::vector<uint32_t> ends;
+        ends.reserve(strings.size());
+
+        size_t total_length = 0;
+        for (const auto& value : strings) {
+            total_length += value.size();
+        }
+        column.data.reserve(total_length);
+
+        for (const auto& value : strings) {
+            column.data.append(value);
+            _overflow = _overflow || column.data.size() > std::numeric_limits<uint32_t>::max();
+            ends.push_back(static_cast<uint32_t>(column.data.size()));
+        }
+
+        AppendBytes(column.offsets, ends.data(), ends.size());
+    }
+
+    void ColumnarWriter::AddInt64(const std::string_view name, const std::vector<int64_t>& values) {
+        Column& column = Add(name, columnar::ColumnType::Int64);
+        AppendBytes(column.values, values.data(), values.size());
+    }
+
+    void ColumnarWriter::AddFloat64(const std::string_view     name,
+                                    const std::vector<double>& values) {
+        Column& column = Add(name, columnar::ColumnType::Float64);
+        AppendBytes(column.values, values.data(), values.size());
+    }
+
+    void ColumnarWriter::AddUtf8(const std::string_view                name,
+                                 const std::vector<std::string_view>& values) {
+        Column& column = Add(name, columnar::ColumnType::Utf8);
+        AppendStrings(values, column);
+
+        // Utf8 keeps the row offsets in the values buffer
+        column.values = std::move(column.offsets);
+        column.offsets.clear();
+    }
+
+    void ColumnarWriter::AddDictionary(const std::string_view                name,
+                                       const std::vector<uint32_t>&         codes,
+                                       const std::vector<std::string_view>& dictionary) {
+        Column& column                = Add(name, columnar::ColumnType::Dictionary);
+        column.header.dictionary_size = static_cast<uint32_t>(dictionary.size());
+        AppendBytes(column.values, codes.data(), codes.size());
+        AppendStrings(dictionary, column);
+    }
+
+    size_t ColumnarWriter::FileSize() const {
+        size_t offset =
+            Align(sizeof(columnar::FileHeader) + _columns.size() * sizeof(columnar::ColumnHeader));
+        for (const auto& column : _columns) {
+            offset = Align(offset + column.values.size());
+            offset = Align(offset + column.offsets.size());
+            offset = Align(offset + column.data.size());
+        }
+        return offset;
+    }
+
+    bool ColumnarWriter::Write(std::FILE* file) const {
+        if (_overflow) {
+            return false;
+        }
+
+        // Layout: headers, then values / offsets / data of each column, each buffer aligned
+        std::vector<columnar::ColumnHeader> headers;
+        headers.reserve(_columns.size());
+
+        size_t offset =
+            Align(sizeof(columnar::FileHeader) + _columns.size() * sizeof(columnar::ColumnHeader));
+        const auto place = [&offset](const std::string& buffer) {
+            const columnar::Buffer placed{offset, buffer.size()};
+            offset = Align(offset + buffer.size());
+            return placed;
+        };
+
+        for (const auto& column : _columns) {
+            columnar::ColumnHeader header = column.header;
+            header.values                 = place(column.values);
+            header.offsets                = place(column.offsets);
+            header.data                   = place(column.data);
+            headers.push_back(header);
+        }
+
+        columnar::FileHeader file_header{};
+        std::memcpy(file_header.magic, columnar::MAGIC, sizeof(columnar::MAGIC));
+        file_header.version       = columnar::VERSION;
+        file_header.columns_count = static_cast<uint32_t>(headers.size());
+        file_header.rows_count    = _rows_count;
+        file_header.file_size     = offset;
+
+        const size_t headers_size = headers.size() * sizeof(columnar::ColumnHeader);
+
+        bool is_written = std::fwrite(&file_header, sizeof(file_header), 1, file) == 1 &&
+                          std::fwrite(headers.data(), 1, headers_size, file) == headers_size;
+
+        size_t written = sizeof(file_header) + headers_size;
+        for (const auto& column : _columns) {
+            for (const std::string* buffer : {&column.values, &column.offsets, &column.data}) {
+                is_written = is_written && WritePadding(file, Align(written) - written) &&
+                             std::fwrite(buffer->data(), 1, buffer->size(), file) == buffer->size();
+                written = Align(written) + buffer->size();
+            }
+        }
+
+        return is_written && WritePadding(file, Align(written) - written);
+    }
+
+    uint32_t StringDictionary::Encode(const std::string_view value) {
+        const auto code              = static_cast<uint32_t>(_values.size());
+        const auto [it, is_inserted] = _codes.try_emplace(value, code);
+        if (is_inserted) {
+            _values.push_back(value);
+        }
+        return it->second;
+    }
+
+    bool ColumnarReader::Fail(std::string error) {
+        Close();
+        _error = std::move(error);
+        return false;
+    }
+
+    bool ColumnarReader::Open(const std::string& path) {
+        Close();
+        _error.clear();
+
+        const int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0) {
+            return Fail(path + ": " + std::strerror(errno));
+        }
+
+        struct stat status{};
+        if (fstat(descriptor, &status) != 0 ||
+            static_cast<size_t>(status.st_size) < sizeof(columnar::FileHeader)) {
+            close(descriptor);
+            return Fail(path + ": not a columnar export");
+        }
+
+        void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+        if (mapping == MAP_FAILED) {
+            return Fail(path + ": " + std::strerror(errno));
+        }
+
+        _data   = static_cast<const char*>(mapping);
+        _size   = static_cast<size_t>(status.st_size);
+        _header = reinterpret_cast<const columnar::FileHeader*>(_data);
+
+        if (std::memcmp(_header->magic, columnar::MAGIC, sizeof(columnar::MAGIC)) != 0) {
+            return Fail(path + ": not a columnar export");
+        }
+        if (_header->version != columnar::VERSION) {
+            return Fail(path + ": unsupported version " + std::to_string(_header->version));
+        }
+        const size_t max_columns =
+            (_size - sizeof(columnar::FileHeader)) / sizeof(columnar::ColumnHeader);
+        if (_header->file_size != _size || _header->columns_count > max_columns) {
+            return Fail(path + ": truncated file");
+        }
+
+        _columns =
+            reinterpret_cast<const columnar::ColumnHeader*>(_data + sizeof(columnar::FileHeader));
+        for (size_t i = 0; i < _header->columns_count; ++i) {
+            if (!Validate(_columns[i])) {
+                return Fail(path + ": malformed column " + std::string(GetName(_columns[i])));
+            }
+        }
+
+        return true;
+    }
+
+    void ColumnarReader::Close() {
+        if (_data) {
+            munmap(const_cast<char*>(_data), _size);
+        }
+        _data    = nullptr;
+        _size    = 0;
+        _header  = nullptr;
+        _columns = nullptr;
+    }
+
+    bool ColumnarReader::Validate(const columnar::ColumnHeader& column) const {
+        const auto fits = [this](const columnar::Buffer& buffer) {
+            return buffer.offset % columnar::ALIGNMENT == 0 && buffer.offset <= _size &&
+                   buffer.length <= _size - buffer.offset;
+        };
+        if (!fits(column.values) || !fits(column.offsets) || !fits(column.data)) {
+            return false;
+        }
+
+        const uint64_t rows = _header->rows_count;
+        switch (column.type) {
+            case columnar::ColumnType::Int64:
+            case columnar::ColumnType::Float64:
+                return column.values.length == rows * sizeof(int64_t);
+            case columnar::ColumnType::Utf8:
+                return column.values.length == rows * sizeof(uint32_t);
+            case columnar::ColumnType::Dictionary:
+                return column.values.length == rows * sizeof(uint32_t) &&
+                       column.offsets.length == uint64_t{column.dictionary_size} * sizeof(uint32_t);
+        }
+        return false;
+    }
+
+    const columnar::ColumnHeader* ColumnarReader::FindColumn(const std::string_view name) const {
+        for (size_t i = 0; i < ColumnsCount(); ++i) {
+            if (GetName(_columns[i]) == name) {
+                return &_columns[i];
+            }
+        }
+        return nullptr;
+    }
+
+    std::string_view ColumnarReader::GetName(const columnar::ColumnHeader& column) const {
+        return {column.name, strnlen(column.name, columnar::COLUMN_NAME_SIZE)};
+    }
+
+    const int64_t* ColumnarReader::Int64Values(const columnar::ColumnHeader& column) const {
+        return reinterpret_cast<const int64_t*>(_data + column.values.offset);
+    }
+
+    const double* ColumnarReader::Float64Values(const columnar::ColumnHeader& column) const {
+        return reinterpret_cast<const double*>(_data + column.values.offset);
+    }
+
+    const uint32_t* ColumnarReader::Codes(const columnar::ColumnHeader& column) const {
+        return reinterpret_cast<const uint32_t*>(_data + column.values.offset);
+    }
+
+    std::string_view ColumnarReader::Slice(const char*     data,
+                                           const uint32_t* ends,
+                                           const size_t    index) {
+        const uint32_t begin = index == 0 ? 0 : ends[index - 1];
+        return begin <= ends[index] ? std::string_view(data + begin, ends[index] - begin)
+                                    : std::string_view();
+    }
+
+    std::string_view ColumnarReader::String(const columnar::ColumnHeader& column,
+                                            const size_t                  row) const {
+        if (column.type == columnar::ColumnType::Dictionary) {
+            return DictionaryValue(column, Codes(column)[row]);
+        }
+
+        const auto* ends = reinterpret_cast<const uint32_t*>(_data + column.values.offset);
+        if (ends[row] > column.data.length) {
+            return {};
+        }
+        return Slice(_data + column.data.offset, ends, row);
+    }
+
+    std::string_view ColumnarReader::DictionaryValue(const columnar::ColumnHeader& column,
+                                                     const uint32_t                code) const {
+        const auto* ends = reinterpret_cast<const uint32_t*>(_data + column.offsets.offset);
+        if (code >= column.dictionary_size || ends[code] > column.data.length) {
+            return {};
+        }
+        return Slice(_data + column.data.offset, ends, code);
+    }
+
+    void ExportColumnar(const std::vector<ReportTradeRecord>& trades,
+                        const std::vector<uint32_t>&          rows,
+                        const AccountIndex&                   account_index,
+                        const GroupIndex&                     group_index,
+                        rapidjson::Value&                     response,
+                        rapidjson::Document::AllocatorType&   allocator,
+                        const ConversionMatrix*               conversion) {
+        const size_t rows_count   = rows.size();
+        const bool   is_converted = conversion != nullptr && !conversion->IsIdentity();
+
+        std::vector<int64_t>          orders(rows_count);
+        std::vector<int64_t>          logins(rows_count);
+        std::vector<int64_t>          open_times(rows_count);
+        std::vector<double>           prices[6]; // volume, open_price, sl, tp, storage, profit
+        std::vector<std::string_view> names(rows_count);
+        std::vector<std::string_view> comments(rows_count);
+        std::vector<uint32_t>         types(rows_count);
+        std::vector<uint32_t>         symbols(rows_count);
+        std::vector<uint32_t>         currencies(rows_count);
+        std::vector<uint32_t>         groups(rows_count);
+        std::vector<double>           rates(is_converted ? rows_count : 0);
+
+        for (auto& column : prices) {
+            column.resize(rows_count);
+        }
+
+        StringDictionary type_dictionary;
+        StringDictionary symbol_dictionary;
+        StringDictionary group_dictionary;
+
+        for (size_t i = 0; i < rows_count; ++i) {
+            const ReportTradeRecord&   trade   = trades[rows[i]];
+            const ReportAccountRecord& account = account_index.Find(trade.login);
+
+            orders[i]     = trade.order;
+            logins[i]     = trade.login;
+            open_times[i] = static_cast<int64_t>(trade.open_time);
+            names[i]      = account.name;
+            comments[i]   = trade.comment;
+            types[i]      = type_dictionary.Encode(
+                utils::ConvertCmdToString(static_cast<int>(trade.cmd)));
+            symbols[i]    = symbol_dictionary.Encode(trade.symbol);
+            currencies[i] = group_index.GetCurrencyId(account.group);
+            groups[i]     = group_dictionary.Encode(account.group);
+
+            prices[0][i] = trade.volume / 100.0;
+            prices[1][i] = trade.open_price;
+            prices[2][i] = trade.sl;
+            prices[3][i] = trade.tp;
+            prices[4][i] = trade.storage;
+            prices[5][i] = trade.profit;
+
+            if (is_converted) {
+                rates[i] = conversion->GetRate(currencies[i], trade.cmd);
+            }
+        }
+
+        // Same conversion and precision as the table cells
+        if (is_converted) {
+            for (size_t column = 1; column < std::size(prices); ++column) {
+                utils::MultiplyDoubles(
+                    prices[column].data(), rates.data(), rows_count, prices[column].data());
+            }
+        }
+        for (auto& column : prices) {
+            utils::TruncateDoubles(column.data(), rows_count, 2, column.data());
+        }
+
+        // Currency codes are the group index ids, the dictionary is the index itself
+        std::vector<std::string_view> currency_dictionary;
+        currency_dictionary.reserve(group_index.CurrencyCount());
+        for (CurrencyId id = 0; id < group_index.CurrencyCount(); ++id) {
+            currency_dictionary.emplace_back(group_index.GetCurrency(id));
+        }
+
+        ColumnarWriter writer(rows_count);
+        writer.AddInt64("order", orders);
+        writer.AddInt64("login", logins);
+        writer.AddUtf8("name", names);
+        writer.AddInt64("open_time", open_times);
+        writer.AddDictionary("type", types, type_dictionary.Values());
+        writer.AddDictionary("symbol", symbols, symbol_dictionary.Values());
+        writer.AddFloat64("volume", prices[0]);
+        writer.AddFloat64("open_price", prices[1]);
+        writer.AddFloat64("sl", prices[2]);
+        writer.AddFloat64("tp", prices[3]);
+        writer.AddFloat64("storage", prices[4]);
+        writer.AddFloat64("profit", prices[5]);
+        writer.AddUtf8("comment", comments);
+        writer.AddDictionary("currency", currencies, currency_dictionary);
+        writer.AddDictionary("group", groups, group_dictionary.Values());
+
+        rapidjson::Value result(rapidjson::kObjectType);
+        result.AddMember("format", "columnar", allocator);
+
+        std::string path;
+        std::FILE*  file = CreateExportFile("ptcol", path);
+        if (!file) {
+            std::cerr << "[PendingTradesReportInterface]: cannot create export file: "
+                      << std::strerror(errno) << std::endl;
+            result.AddMember("error", "cannot create export file", allocator);
+        } else if (const bool is_written = writer.Write(file);
+                   std::fclose(file) != 0 || !is_written) {
+            std::cerr << "[PendingTradesReportInterface]: export file write failed: " << path
+                      << std::endl;
+            std::remove(path.c_str());
+            result.AddMember("error", "export file write failed", allocator);
+        } else {
+            const auto path_length = static_cast<rapidjson::SizeType>(path.size());
+            result.AddMember(
+                "file", rapidjson::Value(path.c_str(), path_length, allocator), allocator);
+            result.AddMember("rows", static_cast<uint64_t>(rows_count), allocator);
+            result.AddMember("bytes", static_cast<uint64_t>(writer.FileSize()), allocator);
+        }
+
+        response.SetObject();
+        response.AddMember("export", result, allocator);
+    }
+} // namespace report
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+#include "AccountIndex.h"
+#include "CurrencyConversion.h"
+#include "GroupIndex.h"
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Binary columnar export, laid out after Arrow IPC: a fixed header, one descriptor per
+    // column, then 64-byte aligned little-endian buffers. A mapped file is read in place,
+    // values are addressed by row without any parsing.
+    //
+    //   FileHeader | ColumnHeader[columns_count] | buffers...
+    //
+    // Column buffers by type:
+    //   Int64, Float64  values: int64_t / double [rows_count]
+    //   Utf8            values: uint32_t end offsets [rows_count], data: bytes
+    //   Dictionary      values: uint32_t codes [rows_count],
+    //                   offsets: uint32_t end offsets [dictionary_size], data: bytes
+    namespace columnar {
+        inline constexpr char     MAGIC[8] = {'P', 'T', 'C', 'O', 'L', '\0', '\0', '\1'};
+        inline constexpr uint32_t VERSION  = 1;
+
+        constexpr size_t ALIGNMENT        = 64;
+        constexpr size_t COLUMN_NAME_SIZE = 16;
+
+        enum class ColumnType : uint32_t { Int64 = 1, Float64 = 2, Utf8 = 3, Dictionary = 4 };
+
+        struct Buffer {
+            uint64_t offset = 0; // from the start of the file
+            uint64_t length = 0; // bytes
+        };
+
+        struct FileHeader {
+            char     magic[8];
+            uint32_t version;
+            uint32_t columns_count;
+            uint64_t rows_count;
+            uint64_t file_size;
+        };
+
+        struct ColumnHeader {
+            char       name[COLUMN_NAME_SIZE]; // zero padded
+            ColumnType type;
+            uint32_t   dictionary_size;
+            Buffer     values;
+            Buffer     offsets;
+            Buffer     data;
+        };
+
+        static_assert(sizeof(FileHeader) == 32);
+        static_assert(sizeof(ColumnHeader) == 72);
+    } // namespace columnar
+
+    // Collects typed columns in memory and writes them out in the columnar layout
+    class ColumnarWriter {
+    public:
+        explicit ColumnarWriter(size_t rows_count) : _rows_count(rows_count) {}
+
+        void AddInt64(std::string_view name, const std::vector<int64_t>& values);
+        void AddFloat64(std::string_view name, const std::vector<double>& values);
+        void AddUtf8(std::string_view name, const std::vector<std::string_view>& values);
+        void AddDictionary(std::string_view                     name,
+                           const std::vector<uint32_t>&         codes,
+                           const std::vector<std::string_view>& dictionary);
+
+        // False on a write error or when a string buffer outgrows 32-bit offsets
+        bool Write(std::FILE* file) const;
+
+        [[nodiscard]] size_t FileSize() const;
+
+    private:
+        struct Column {
+            columnar::ColumnHeader header{};
+            std::string            values;
+            std::string            offsets;
+            std::string            data;
+        };
+
+        size_t              _rows_count;
+        std::vector<Column> _columns;
+        bool                _overflow = false;
+
+        Column& Add(std::string_view name, columnar::ColumnType type);
+
+        // Appends the strings to data and their end offsets to offsets
+        void AppendStrings(const std::vector<std::string_view>& strings, Column& column);
+    };
+
+    // Assigns dense codes to distinct strings in order of first appearance. The strings are
+    // referenced, they must outlive the dictionary.
+    class StringDictionary {
+    public:
+        uint32_t Encode(std::string_view value);
+
+        [[nodiscard]] const std::vector<std::string_view>& Values() const { return _values; }
+
+    private:
+        std::vector<std::string_view>                  _values;
+        std::unordered_map<std::string_view, uint32_t> _codes;
+    };
+
+    // Read-only view of a columnar export file. The file is mapped, accessors point into the
+    // mapping and stay valid while the reader is open.
+    class ColumnarReader {
+    public:
+        ColumnarReader() = default;
+        ~ColumnarReader() { Close(); }
+
+        ColumnarReader(const ColumnarReader&)            = delete;
+        ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+        // Maps the file and validates the header and every buffer's bounds
+        bool Open(const std::string& path);
+        void Close();
+
+        [[nodiscard]] const std::string& GetError() const { return _error; }
+
+        [[nodiscard]] size_t RowsCount() const { return _header ? _header->rows_count : 0; }
+        [[nodiscard]] size_t ColumnsCount() const { return _header ? _header->columns_count : 0; }
+
+        [[nodiscard]] const columnar::ColumnHeader& GetColumn(const size_t index) const {
+            return _columns[index];
+        }
+
+        // nullptr when there is no such column
+        [[nodiscard]] const columnar::ColumnHeader* FindColumn(std::string_view name) const;
+
+        [[nodiscard]] std::string_view GetName(const columnar::ColumnHeader& column) const;
+
+        // Typed buffers; the column type is checked by Open, not here
+        [[nodiscard]] const int64_t*  Int64Values(const columnar::ColumnHeader& column) const;
+        [[nodiscard]] const double*   Float64Values(const columnar::ColumnHeader& column) const;
+        [[nodiscard]] const uint32_t* Codes(const columnar::ColumnHeader& column) const;
+
+        // Cell of a Utf8 or Dictionary column
+        [[nodiscard]] std::string_view String(const columnar::ColumnHeader& column,
+                                              size_t                        row) const;
+
+        // Dictionary entry by code
+        [[nodiscard]] std::string_view DictionaryValue(const columnar::ColumnHeader& column,
+                                                       uint32_t                      code) const;
+
+    private:
+        const char*                   _data    = nullptr;
+        size_t                        _size    = 0;
+        const columnar::FileHeader*   _header  = nullptr;
+        const columnar::ColumnHeader* _columns = nullptr;
+        std::string                   _error;
+
+        bool Fail(std::string error);
+        bool Validate(const columnar::ColumnHeader& column) const;
+
+        [[nodiscard]] static std::string_view Slice(const char*     data,
+                                                    const uint32_t* ends,
+                                                    size_t          index);
+    };
+
+    // Writes the rows of the report as a columnar file in the temporary directory and fills
+    // `response` with {"export": {"format", "rows", "bytes", "file"}}. Money columns are
+    // converted with the `conversion` rates, when given.
+    void ExportColumnar(const std::vector<ReportTradeRecord>& trades,
+                        const std::vector<uint32_t>&          rows,
+                        const AccountIndex&                   account_index,
+                        const GroupIndex&                     group_index,
+                        rapidjson::Value&                     response,
+                        rapidjson::Document::AllocatorType&   allocator,
+                        const ConversionMatrix*               conversion = nullptr);
+} // namespace report
@@ -0,0 +1,158 @@
+#include "CountingServer.h"
+
+namespace report {
+    int CountingServer::GetLogs(time_t from, time_t to, const std::string& type, const std::string& filter, std::vector<ReportServerLog>* logs) {
+        ++_calls;
+        return _server->GetLogs(from, to, type, filter, logs);
+    }
+
+    int CountingServer::GetAccountsByGroup(const std::string& group, std::vector<ReportAccountRecord>* accounts) {
+        ++_calls;
+        return _server->GetAccountsByGroup(group, accounts);
+    }
+
+    int CountingServer::GetAccountByLogin(int login, ReportAccountRecord* account) {
+        ++_calls;
+        return _server->GetAccountByLogin(login, account);
+    }
+
+    int CountingServer::GetAccountBalanceByLogin(int login, ReportMarginLevel* margin) {
+        ++_calls;
+        return _server->GetAccountBalanceByLogin(login, margin);
+    }
+
+    int CountingServer::GetMarginLevelByGroup(const std::string& group, std::vector<ReportMarginLevel>* margins) {
+        ++_calls;
+        return _server->GetMarginLevelByGroup(group, margins);
+    }
+
+    int CountingServer::GetAccountsEquitiesByGroup(time_t from, time_t to, const std::string& group_filter, std::vector<ReportEquityRecord>* equities) {
+        ++_calls;
+        return _server->GetAccountsEquitiesByGroup(from, to, group_filter, equities);
+    }
+
+    int CountingServer::GetAccountsEquitiesByLogin(time_t from, time_t to, int login, std::vector<ReportEquityRecord>* equities) {
+        ++_calls;
+        return _server->GetAccountsEquitiesByLogin(from, to, login, equities);
+    }
+
+    int CountingServer::GetOpenTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetOpenTradesByLogin(login, trades);
+    }
+
+    int CountingServer::GetPendingTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetPendingTradesByLogin(login, trades);
+    }
+
+    int CountingServer::GetOpenTradesByMagic(int magic, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetOpenTradesByMagic(magic, trades);
+    }
+
+    int CountingServer::GetOpenTradeByOrder(int order, ReportTradeRecord* trade) {
+        ++_calls;
+        return _server->GetOpenTradeByOrder(order, trade);
+    }
+
+    int CountingServer::GetOpenTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) {
+        ++_calls;
+        return _server->GetOpenTradeByGwUUID(gw_uuid, trade);
+    }
+
+    int CountingServer::GetCloseTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) {
+        ++_calls;
+        return _server->GetCloseTradeByGwUUID(gw_uuid, trade);
+    }
+
+    int CountingServer::GetOpenTradeByGwOrder(int gw_order, ReportTradeRecord* trade) {
+        ++_calls;
+        return _server->GetOpenTradeByGwOrder(gw_order, trade);
+    }
+
+    int CountingServer::GetCloseTradeByGwOrder(int gw_order, ReportTradeRecord* trade) {
+        ++_calls;
+        return _server->GetCloseTradeByGwOrder(gw_order, trade);
+    }
+
+    int CountingServer::GetCloseTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetCloseTradesByLogin(login, trades);
+    }
+
+    int CountingServer::GetCloseTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetCloseTradesByGroup(filter_group, from, to, trades);
+    }
+
+    int CountingServer::GetPendingTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetPendingTradesByGroup(filter_group, from, to, trades);
+    }
+
+    int CountingServer::GetOpenTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetOpenTradesByGroup(filter_group, from, to, trades);
+    }
+
+    int CountingServer::GetAllOpenTrades(std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetAllOpenTrades(trades);
+    }
+
+    int CountingServer::GetTransactionsByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetTransactionsByGroup(filter_group, from, to, trades);
+    }
+
+    int CountingServer::GetTransactionsByLogin(int login, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) {
+        ++_calls;
+        return _server->GetTransactionsByLogin(login, from, to, trades);
+    }
+
+    int CountingServer::CalculateCommission(const ReportTradeRecord& trade, double* calculated_commission) {
+        ++_calls;
+        return _server->CalculateCommission(trade, calculated_commission);
+    }
+
+    int CountingServer::CalculateSwap(const ReportTradeRecord& trade, double* calculated_swap) {
+        ++_calls;
+        return _server->CalculateSwap(trade, calculated_swap);
+    }
+
+    int CountingServer::CalculateProfit(const ReportTradeRecord& trade, double* calculated_profit) {
+        ++_calls;
+        return _server->CalculateProfit(trade, calculated_profit);
+    }
+
+    int CountingServer::CalculateMargin(const ReportTradeRecord& trade, double* calculated_margin) {
+        ++_calls;
+        return _server->CalculateMargin(trade, calculated_margin);
+    }
+
+    int CountingServer::CalculateConvertRateByCurrency(const std::string& from_cur, const std::string& to_cur, int cmd, double* multiplier) {
+        ++_calls;
+        return _server->CalculateConvertRateByCurrency(from_cur, to_cur, cmd, multiplier);
+    }
+
+    int CountingServer::GetSymbol(const std::string& symbol, ReportSymbolRecord* cs) {
+        ++_calls;
+        return _server->GetSymbol(symbol, cs);
+    }
+
+    int CountingServer::GetGroup(const std::string& group_name, ReportGroupRecord* group) {
+        ++_calls;
+        return _server->GetGroup(group_name, group);
+    }
+
+    int CountingServer::GetAllGroups(std::vector<ReportGroupRecord>* groups) {
+        ++_calls;
+        return _server->GetAllGroups(groups);
+    }
+
+    int CountingServer::GetCandles(const std::string& symbol, const std::string& frame, time_t from, time_t to, std::vector<ReportCandleRecord>* candles) {
+        ++_calls;
+        return _server->GetCandles(symbol, frame, from, to, candles);
+    }
+} // namespace report
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Forwards every call to the wrapped server and counts them. Used by the perf trace; the
+    // wrapper lives on the report's stack and must not be retained past the report. Calls may
+    // come from the worker pool (partitioned fetches), the count is atomic.
+    class CountingServer final : public ReportServerInterface {
+    public:
+        explicit CountingServer(ReportServerInterface* server) : _server(server) {}
+
+        [[nodiscard]] uint64_t GetCallCount() const { return _calls; }
+
+        int GetLogs(time_t from, time_t to, const std::string& type, const std::string& filter, std::vector<ReportServerLog>* logs) override;
+
+        int GetAccountsByGroup(const std::string& group, std::vector<ReportAccountRecord>* accounts) override;
+        int GetAccountByLogin(int login, ReportAccountRecord* account) override;
+        int GetAccountBalanceByLogin(int login, ReportMarginLevel* margin) override;
+        int GetMarginLevelByGroup(const std::string& group, std::vector<ReportMarginLevel>* margins) override;
+        int GetAccountsEquitiesByGroup(time_t from, time_t to, const std::string& group_filter, std::vector<ReportEquityRecord>* equities) override;
+        int GetAccountsEquitiesByLogin(time_t from, time_t to, int login, std::vector<ReportEquityRecord>* equities) override;
+
+        int GetOpenTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override;
+        int GetPendingTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override;
+        int GetOpenTradesByMagic(int magic, std::vector<ReportTradeRecord>* trades) override;
+        int GetOpenTradeByOrder(int order, ReportTradeRecord* trade) override;
+        int GetOpenTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) override;
+        int GetCloseTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) override;
+        int GetOpenTradeByGwOrder(int gw_order, ReportTradeRecord* trade) override;
+        int GetCloseTradeByGwOrder(int gw_order, ReportTradeRecord* trade) override;
+        int GetCloseTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override;
+        int GetCloseTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetPendingTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetOpenTradesByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetAllOpenTrades(std::vector<ReportTradeRecord>* trades) override;
+        int GetTransactionsByGroup(const std::string& filter_group, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+        int GetTransactionsByLogin(int login, time_t from, time_t to, std::vector<ReportTradeRecord>* trades) override;
+
+        int CalculateCommission(const ReportTradeRecord& trade, double* calculated_commission) override;
+        int CalculateSwap(const ReportTradeRecord& trade, double* calculated_swap) override;
+        int CalculateProfit(const ReportTradeRecord& trade, double* calculated_profit) override;
+        int CalculateMargin(const ReportTradeRecord& trade, double* calculated_margin) override;
+        int CalculateConvertRateByCurrency(const std::string& from_cur, const std::string& to_cur, int cmd, double* multiplier) override;
+
+        int GetSymbol(const std::string& symbol, ReportSymbolRecord* cs) override;
+        int GetGroup(const std::string& group_name, ReportGroupRecord* group) override;
+        int GetAllGroups(std::vector<ReportGroupRecord>* groups) override;
+
+        int GetCandles(const std::string& symbol, const std::string& frame, time_t from, time_t to, std::vector<ReportCandleRecord>* candles) override;
+
+    private:
+        ReportServerInterface* _server;
+        std::atomic<uint64_t>  _calls{0};
+    };
+} // namespace report
@@ -0,0 +1,233 @@
+#include "CsvExport.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+#include "Allocators.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace report {
+    namespace {
+        bool NeedsQuotes(const char* value, const size_t length) {
+            for (size_t i = 0; i < length; ++i) {
+                const char c = value[i];
+                if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Cells a spreadsheet would evaluate as a formula
+        bool LooksLikeFormula(const char* value, const size_t length) {
+            return length > 0 && (value[0] == '=' || value[0] == '+' || value[0] == '-' ||
+                                  value[0] == '@' || value[0] == '\t' || value[0] == '\r');
+        }
+    } // namespace
+
+    std::FILE* CreateExportFile(const std::string_view extension, std::string& path) {
+        std::error_code ec;
+        const auto      directory = std::filesystem::temp_directory_path(ec);
+
+        const std::string file_name = "pending_trades_XXXXXX." + std::string(extension);
+        std::string       name_template =
+            ((ec ? std::filesystem::path("/tmp") : directory) / file_name).string();
+
+        const int suffix_length = static_cast<int>(extension.size() + 1);
+        const int descriptor    = mkstemps(name_template.data(), suffix_length);
+        if (descriptor < 0) {
+            return nullptr;
+        }
+
+        std::FILE* file = fdopen(descriptor, "wb");
+        if (!file) {
+            close(descriptor);
+            std::remove(name_template.c_str());
+            return nullptr;
+        }
+
+        path = std::move(name_template);
+        return file;
+    }
+
+    void CsvWriter::Separator() {
+        if (!_is_first_cell) {
+            Append(',');
+        }
+        _is_first_cell = false;
+    }
+
+    void CsvWriter::EndRow() {
+        Append("\r\n", 2);
+        ++_rows_count;
+    }
+
+    void CsvWriter::String(const char* value, const size_t length) {
+        Separator();
+
+        const bool is_formula = LooksLikeFormula(value, length);
+        if (!is_formula && !NeedsQuotes(value, length)) {
+            Append(value, length);
+            return;
+        }
+
+        Append('"');
+        if (is_formula) {
+            Append('\'');
+        }
+        for (size_t i = 0; i < length; ++i) {
+            if (value[i] == '"') {
+                Append('"');
+            }
+            Append(value[i]);
+        }
+        Append('"');
+    }
+
+    void CsvWriter::Number(const double value) {
+        Separator();
+
+        char       buffer[32];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        Append(buffer, ec == std::errc() ? static_cast<size_t>(end - buffer) : 0);
+    }
+
+    void CsvWriter::Integer(const int64_t value) {
+        Separator();
+
+        char       buffer[24];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        Append(buffer, ec == std::errc() ? static_cast<size_t>(end - buffer) : 0);
+    }
+
+    void CsvWriter::Bool(const bool value) {
+        Separator();
+        Append(value ? "true" : "false", value ? 4 : 5);
+    }
+
+    void CsvWriter::Cell(const JSONValue& value) {
+        // Arrays and objects are exported as their JSON text
+        ScratchPool         pool;
+        rapidjson::Document document(&pool.Get());
+        to_json_value(value, document, document.GetAllocator());
+
+        rapidjson::StringBuffer                    buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        document.Accept(writer);
+
+        String(buffer.GetString(), buffer.GetSize());
+    }
+
+    void CsvWriter::Append(const char* data, size_t length) {
+        while (length > 0) {
+            if (_used == BUFFER_SIZE) {
+                Flush();
+            }
+            const size_t chunk = std::min(length, BUFFER_SIZE - _used);
+            std::memcpy(_buffer.data() + _used, data, chunk);
+            _used += chunk;
+            data += chunk;
+            length -= chunk;
+        }
+    }
+
+    void CsvWriter::Append(const char c) {
+        if (_used == BUFFER_SIZE) {
+            Flush();
+        }
+        _buffer[_used++] = c;
+    }
+
+    bool CsvWriter::Flush() {
+        if (_used > 0) {
+            if (_file) {
+                _failed = _failed || std::fwrite(_buffer.data(), 1, _used, _file) != _used;
+            } else if (_output) {
+                _output->append(_buffer.data(), _used);
+            }
+            _bytes_count += _used;
+            _used = 0;
+        }
+        return !_failed;
+    }
+
+    void ExportCsv(const std::vector<std::string_view>&   header,
+                   const std::function<void(RowWriter&)>& write_rows,
+                   const bool                             to_file,
+                   const size_t                           expected_bytes,
+                   rapidjson::Value&                      response,
+                   rapidjson::Document::AllocatorType&    allocator) {
+        rapidjson::Value result(rapidjson::kObjectType);
+        result.AddMember("format", "csv", allocator);
+
+        std::string content;
+        std::string path;
+        std::FILE*  file = nullptr;
+
+        if (to_file) {
+            file = CreateExportFile("csv", path);
+            if (!file) {
+                std::cerr << "[PendingTradesReportInterface]: cannot create export file: "
+                          << std::strerror(errno) << std::endl;
+                result.AddMember("error", "cannot create export file", allocator);
+
+                response.SetObject();
+                response.AddMember("export", result, allocator);
+                return;
+            }
+        } else {
+            content.reserve(expected_bytes);
+        }
+
+        size_t rows_count  = 0;
+        size_t bytes_count = 0;
+        bool   is_written  = true;
+
+        {
+            CsvWriter writer = file ? CsvWriter(file) : CsvWriter(content);
+
+            writer.BeginRow();
+            for (const auto& name : header) {
+                writer.String(name.data(), name.size());
+            }
+            writer.EndRow();
+
+            write_rows(writer);
+
+            is_written  = writer.Flush();
+            rows_count  = writer.RowsCount() - 1;
+            bytes_count = writer.BytesCount();
+        }
+
+        if (file) {
+            is_written = std::fclose(file) == 0 && is_written;
+            if (!is_written) {
+                std::cerr << "[PendingTradesReportInterface]: export file write failed: " << path
+                          << std::endl;
+                std::remove(path.c_str());
+                result.AddMember("error", "export file write failed", allocator);
+            } else {
+                const auto path_length = static_cast<rapidjson::SizeType>(path.size());
+                result.AddMember(
+                    "file", rapidjson::Value(path.c_str(), path_length, allocator), allocator);
+            }
+        } else {
+            const auto content_length = static_cast<rapidjson::SizeType>(content.size());
+            result.AddMember("content",
+                             rapidjson::Value(content.data(), content_length, allocator),
+                             allocator);
+        }
+
+        result.AddMember("rows", static_cast<uint64_t>(rows_count), allocator);
+        result.AddMember("bytes", static_cast<uint64_t>(bytes_count), allocator);
+
+        response.SetObject();
+        response.AddMember("export", result, allocator);
+    }
+} // namespace report
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <rapidjson/document.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sbxTableBuilder/ColumnStore.hpp"
+
+namespace report {
+    // RowWriter producing RFC 4180 CSV. Output goes through a fixed block that is flushed to a
+    // file or appended to a string, so a file export runs in constant memory whatever the row
+    // count. Numbers use the shortest round-trip form, text cells that a spreadsheet would
+    // take for a formula get a leading apostrophe.
+    class CsvWriter final : public RowWriter {
+    public:
+        explicit CsvWriter(std::string& output) : _output(&output) {}
+        explicit CsvWriter(std::FILE* file) : _file(file) {}
+
+        ~CsvWriter() override { Flush(); }
+
+        CsvWriter(const CsvWriter&)            = delete;
+        CsvWriter& operator=(const CsvWriter&) = delete;
+
+        void BeginRow() override { _is_first_cell = true; }
+        void EndRow() override;
+
+        void String(const char* value, size_t length) override;
+        void Number(double value) override;
+        void Integer(int64_t value) override;
+        void Bool(bool value) override;
+        void Cell(const JSONValue& value) override;
+
+        using RowWriter::String;
+
+        // False once a file write has failed
+        bool Flush();
+
+        [[nodiscard]] size_t RowsCount() const { return _rows_count; }
+        [[nodiscard]] size_t BytesCount() const { return _bytes_count + _used; }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+        std::string*                   _output = nullptr;
+        std::FILE*                     _file   = nullptr;
+        std::array<char, BUFFER_SIZE> _buffer;
+        size_t                         _used          = 0;
+        size_t                         _bytes_count   = 0;
+        size_t                         _rows_count    = 0;
+        bool                           _is_first_cell = true;
+        bool                           _failed        = false;
+
+        void Separator();
+        void Append(const char* data, size_t length);
+        void Append(char c);
+    };
+
+    // Creates an empty pending_trades_XXXXXX.<extension> file in the temporary directory and
+    // opens it for writing, nullptr on failure
+    std::FILE* CreateExportFile(std::string_view extension, std::string& path);
+
+    // Writes a CSV export (header of column keys, then the rows from `write_rows`) and fills
+    // `response` with {"export": {"format", "rows", "bytes", "content" | "file"}}.
+    // `expected_bytes` pre-sizes the in-memory content (0 when unknown).
+    void ExportCsv(const std::vector<std::string_view>&   header,
+                   const std::function<void(RowWriter&)>& write_rows,
+                   bool                                   to_file,
+                   size_t                                 expected_bytes,
+                   rapidjson::Value&                      response,
+                   rapidjson::Document::AllocatorType&    allocator);
+} // namespace report
@@ -0,0 +1,127 @@
+#include "CurrencyConversion.h"
+
+#include <iostream>
+
+namespace report {
+    RateCache& RateCache::Instance() {
+        static RateCache cache;
+        return cache;
+    }
+
+    std::optional<double> RateCache::Get(const std::string& from,
+                                         const std::string& to,
+                                         const TradeSide    side) {
+        const std::string key = MakeKey(from, to, side);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            return std::nullopt;
+        }
+        if (it->second.expires_at <= Clock::now()) {
+            _entries.erase(it);
+            return std::nullopt;
+        }
+        return it->second.rate;
+    }
+
+    void RateCache::Put(const std::string& from,
+                        const std::string& to,
+                        const TradeSide    side,
+                        const double       rate) {
+        std::string key = MakeKey(from, to, side);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries[std::move(key)] = {rate, Clock::now() + _ttl};
+    }
+
+    void RateCache::Clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+    }
+
+    void RateCache::Configure(const std::chrono::milliseconds ttl) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ttl = ttl;
+    }
+
+    std::string RateCache::MakeKey(const std::string& from,
+                                   const std::string& to,
+                                   const TradeSide    side) {
+        // Length-prefixed, so codes cannot run into each other
+        std::string key;
+        key.reserve(from.size() + to.size() + 8);
+        key += std::to_string(from.size());
+        key += ':';
+        key += from;
+        key += to;
+        key += side == TradeSide::Buy ? 'B' : 'S';
+        return key;
+    }
+
+    ConversionMatrix::ConversionMatrix(const GroupIndex& group_index, std::string target_currency)
+        : _group_index(group_index),
+          _target_currency(std::move(target_currency)),
+          _rates(group_index.CurrencyCount() * 2, 1.0) {}
+
+    size_t ConversionMatrix::Build(ReportServerInterface*                server,
+                                   const std::vector<ReportTradeRecord>& trades,
+                                   const std::vector<uint32_t>&          rows,
+                                   const AccountIndex&                   account_index) {
+        // Keys met in the rows; the matrix is tiny (currencies x 2), rows only mark its cells
+        std::vector<bool> is_used(_rates.size(), false);
+        for (const uint32_t row : rows) {
+            const ReportTradeRecord& trade    = trades[row];
+            const CurrencyId         currency = _group_index.GetCurrencyId(
+                account_index.Find(trade.login).group);
+            is_used[currency * 2 + static_cast<size_t>(GetTradeSide(trade.cmd))] = true;
+        }
+
+        size_t cache_hits = 0;
+        for (CurrencyId currency = 0; currency < _group_index.CurrencyCount(); ++currency) {
+            const std::string& from = _group_index.GetCurrency(currency);
+            if (currency == GroupIndex::UNKNOWN_CURRENCY || from == _target_currency) {
+                continue;
+            }
+
+            for (const TradeSide side : {TradeSide::Buy, TradeSide::Sell}) {
+                const size_t cell = currency * 2 + static_cast<size_t>(side);
+                if (!is_used[cell]) {
+                    continue;
+                }
+
+                if (const auto rate = RateCache::Instance().Get(from, _target_currency, side)) {
+                    _rates[cell] = *rate;
+                    ++cache_hits;
+                } else {
+                    // The side's market command stands for every command of that side
+                    const auto cmd =
+                        side == TradeSide::Buy ? ReportTradeCommand::Buy : ReportTradeCommand::Sell;
+                    double multiplier = 1;
+
+                    try {
+                        if (server->CalculateConvertRateByCurrency(
+                                from, _target_currency, static_cast<int>(cmd), &multiplier) ==
+                            RET_OK) {
+                            RateCache::Instance().Put(from, _target_currency, side, multiplier);
+                        } else {
+                            // A failed lookup converts at 1 for this report and is retried by
+                            // the next one
+                            multiplier = 1;
+                        }
+                    } catch (const std::exception& e) {
+                        std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+                        multiplier = 1;
+                    }
+
+                    _rates[cell] = multiplier;
+                }
+
+                _is_identity = _is_identity && _rates[cell] == 1.0;
+            }
+        }
+
+        return cache_hits;
+    }
+} // namespace report
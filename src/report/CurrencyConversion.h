@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AccountIndex.h"
+#include "GroupIndex.h"
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Rates depend on the direction of the trade only: buy commands (even) convert at one rate,
+    // sell commands (odd) at the other
+    enum class TradeSide : uint8_t { Buy, Sell };
+
+    inline TradeSide GetTradeSide(const ReportTradeCommand cmd) {
+        return static_cast<int>(cmd) % 2 == 0 ? TradeSide::Buy : TradeSide::Sell;
+    }
+
+    // Process-wide cache of conversion rates keyed by (from, to, side). Rates change slowly
+    // compared to the report rate, an entry is reused until its TTL runs out.
+    class RateCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr std::chrono::milliseconds DEFAULT_TTL{60'000};
+
+        static RateCache& Instance();
+
+        // Cached rate, nullopt on miss or expired entry
+        std::optional<double> Get(const std::string& from, const std::string& to, TradeSide side);
+
+        void Put(const std::string& from, const std::string& to, TradeSide side, double rate);
+
+        void Clear();
+
+        void Configure(std::chrono::milliseconds ttl);
+
+    private:
+        struct Entry {
+            double            rate = 1;
+            Clock::time_point expires_at;
+        };
+
+        std::mutex                             _mutex;
+        std::unordered_map<std::string, Entry> _entries;
+
+        std::chrono::milliseconds _ttl = DEFAULT_TTL;
+
+        static std::string MakeKey(const std::string& from, const std::string& to, TradeSide side);
+    };
+
+    // Per-report conversion of money columns into the target currency: one rate per (account
+    // currency, side) met in the report, resolved through the RateCache with at most one server
+    // call per key. Currencies equal to the target and unknown ones convert at 1.
+    class ConversionMatrix {
+    public:
+        ConversionMatrix(const GroupIndex& group_index, std::string target_currency);
+
+        // Resolves the rates of the selected rows (indices into trades). Returns the number of
+        // rates taken from the RateCache.
+        size_t Build(ReportServerInterface*                server,
+                     const std::vector<ReportTradeRecord>& trades,
+                     const std::vector<uint32_t>&          rows,
+                     const AccountIndex&                   account_index);
+
+        [[nodiscard]] double GetRate(const CurrencyId currency, const TradeSide side) const {
+            return _rates[currency * 2 + static_cast<size_t>(side)];
+        }
+
+        [[nodiscard]] double GetRate(const CurrencyId currency, const ReportTradeCommand cmd) const {
+            return GetRate(currency, GetTradeSide(cmd));
+        }
+
+        // Every resolved rate is 1: the money columns are left as they are
+        [[nodiscard]] bool IsIdentity() const { return _is_identity; }
+
+        [[nodiscard]] const std::string& GetTargetCurrency() const { return _target_currency; }
+
+    private:
+        const GroupIndex&   _group_index;
+        std::string         _target_currency;
+        std::vector<double> _rates; // [currency * 2 + side]
+        bool                _is_identity = true;
+    };
+} // namespace report
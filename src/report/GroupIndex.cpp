@@ -0,0 +1,31 @@
+#include "GroupIndex.h"
+
+namespace report {
+    GroupIndex::GroupIndex() {
+        InternCurrency("N/A"); // группа не найдена - валюта не определена
+    }
+
+    void GroupIndex::Build(const std::vector<ReportGroupRecord>& groups) {
+        _currency_by_group.clear();
+        _currency_by_group.reserve(groups.size());
+
+        for (const auto& group : groups) {
+            // First match wins, as the former linear scan did
+            _currency_by_group.emplace(group.group, InternCurrency(group.currency));
+        }
+    }
+
+    CurrencyId GroupIndex::GetCurrencyId(const std::string& group_name) const {
+        const auto it = _currency_by_group.find(group_name);
+        return it != _currency_by_group.end() ? it->second : UNKNOWN_CURRENCY;
+    }
+
+    CurrencyId GroupIndex::InternCurrency(const std::string& currency) {
+        const auto [it, inserted] =
+            _currency_ids.emplace(currency, static_cast<CurrencyId>(_currencies.size()));
+        if (inserted) {
+            _currencies.push_back(currency);
+        }
+        return it->second;
+    }
+} // namespace report
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ReportServerInterface.h"
+
+namespace report {
+    using CurrencyId = uint32_t;
+
+    // Group dimension built once per report: group name -> interned currency id. Currency codes
+    // are stored once, rows and totals carry the id.
+    class GroupIndex {
+    public:
+        // Id of the currency used for groups that are not known to the server.
+        static constexpr CurrencyId UNKNOWN_CURRENCY = 0;
+
+        GroupIndex();
+
+        void Build(const std::vector<ReportGroupRecord>& groups);
+
+        [[nodiscard]] CurrencyId GetCurrencyId(const std::string& group_name) const;
+
+        [[nodiscard]] const std::string& GetCurrency(CurrencyId id) const { return _currencies[id]; }
+
+        [[nodiscard]] size_t CurrencyCount() const { return _currencies.size(); }
+
+    private:
+        std::vector<std::string>                    _currencies;
+        std::unordered_map<std::string, CurrencyId> _currency_ids;
+        std::unordered_map<std::string, CurrencyId> _currency_by_group;
+
+        CurrencyId InternCurrency(const std::string& currency);
+    };
+} // namespace report
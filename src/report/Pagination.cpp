@@ -0,0 +1,47 @@
+#include "Pagination.h"
+
+#include <algorithm>
+
+namespace report {
+    RowWindow SelectWindow(const std::vector<ReportTradeRecord>& trades,
+                           std::vector<uint32_t>                 rows,
+                           const ReportRequest&                  request,
+                           const RowSorter&                      sorter) {
+        RowWindow window;
+
+        const std::vector<SortKey> sort = request.GetEffectiveSort();
+
+        // The keyset cursor continues an `order`-sorted listing
+        std::optional<int> cursor;
+        bool               cursor_descending = true;
+        if (request.cursor && !sort.empty() && sort.front().column == "order") {
+            cursor            = request.cursor;
+            cursor_descending = sort.front().descending;
+        }
+
+        std::vector<uint32_t> candidates = std::move(rows);
+        if (cursor) {
+            candidates.erase(std::remove_if(candidates.begin(),
+                                            candidates.end(),
+                                            [&](const uint32_t row) {
+                                                return cursor_descending
+                                                           ? trades[row].order >= *cursor
+                                                           : trades[row].order <= *cursor;
+                                            }),
+                             candidates.end());
+        }
+
+        const size_t begin = std::min(request.offset, candidates.size());
+        const size_t end   = request.limit
+                                 ? begin + std::min(*request.limit, candidates.size() - begin)
+                                 : candidates.size();
+
+        sorter.Sort(candidates, sort, end);
+
+        window.has_more = end < candidates.size();
+        window.rows.assign(candidates.begin() + static_cast<std::ptrdiff_t>(begin),
+                           candidates.begin() + static_cast<std::ptrdiff_t>(end));
+
+        return window;
+    }
+} // namespace report
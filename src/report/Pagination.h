@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ReportRequest.h"
+#include "ReportServerInterface.h"
+#include "RowSorter.h"
+
+namespace report {
+    // Requested window of the pending trades table, as indices into the fetched trades
+    struct RowWindow {
+        std::vector<uint32_t> rows;
+        bool                  has_more = false; // rows remain past the window
+    };
+
+    // Orders the selected rows by the request's sort keys (`order` DESC, the table's declared
+    // order, when paginating without one) and keeps only the requested window. Only
+    // offset + limit rows are ever ordered, the rest is partitioned away.
+    RowWindow SelectWindow(const std::vector<ReportTradeRecord>& trades,
+                           std::vector<uint32_t>                 rows,
+                           const ReportRequest&                  request,
+                           const RowSorter&                      sorter);
+} // namespace report
@@ -0,0 +1,257 @@
+#include "PendingTradesView.h"
+
+#include <iostream>
+#include <limits>
+
+namespace report {
+    namespace {
+        bool IsPendingCommand(const ReportTradeCommand cmd) {
+            switch (cmd) {
+                case ReportTradeCommand::BuyLimit:
+                case ReportTradeCommand::SellLimit:
+                case ReportTradeCommand::BuyStop:
+                case ReportTradeCommand::SellStop:
+                case ReportTradeCommand::BuyStopLimit:
+                case ReportTradeCommand::SellStopLimit:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    } // namespace
+
+    PendingTradesView& PendingTradesView::Instance() {
+        static PendingTradesView view;
+        return view;
+    }
+
+    PendingTradesView::Snapshot PendingTradesView::Query(ReportServerInterface* server,
+                                                         const std::string&     group_mask) {
+        bool needs_resolve = false;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_is_live) {
+                return nullptr;
+            }
+
+            const auto it = _partitions.find(group_mask);
+            if (it != _partitions.end() && !it->second.is_seeding) {
+                if (Clock::now() - it->second.seeded_at >= RESEED_INTERVAL) {
+                    _partitions.erase(it);
+                } else if (it->second.unresolved.empty()) {
+                    return it->second.trades;
+                } else {
+                    needs_resolve = true;
+                }
+            } else if (it != _partitions.end()) {
+                // Another report is seeding this partition, fetch directly meanwhile
+                return nullptr;
+            }
+        }
+
+        if (needs_resolve) {
+            ResolveLogins(server, group_mask);
+
+            // A failed resolve leaves orders in `unresolved`: the view would miss them, the
+            // report fetches directly instead
+            std::lock_guard<std::mutex> lock(_mutex);
+            const auto                  it = _partitions.find(group_mask);
+            if (it == _partitions.end() || it->second.is_seeding ||
+                !it->second.unresolved.empty()) {
+                return nullptr;
+            }
+            return it->second.trades;
+        }
+
+        return Seed(server, group_mask);
+    }
+
+    void PendingTradesView::OnTradeEvent(const int record_type, const ReportTradeRecord& trade) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _is_live = true;
+
+        const Event event{record_type, trade};
+        for (auto& [group_mask, partition] : _partitions) {
+            if (partition.is_seeding) {
+                partition.backlog.push_back(event);
+            } else {
+                Apply(partition, event);
+            }
+        }
+    }
+
+    void PendingTradesView::Clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _partitions.clear();
+        _is_live = false;
+    }
+
+    bool PendingTradesView::IsLive() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _is_live;
+    }
+
+    PendingTradesView::Snapshot PendingTradesView::Seed(ReportServerInterface* server,
+                                                        const std::string&     group_mask) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto [it, inserted] = _partitions.try_emplace(group_mask);
+            if (!inserted) {
+                return nullptr;
+            }
+            it->second.is_seeding = true;
+        }
+
+        auto                             trades = std::make_shared<Trades>();
+        std::vector<ReportAccountRecord> accounts;
+        bool                             is_seeded = true;
+
+        try {
+            server->GetPendingTradesByGroup(
+                group_mask, 0, std::numeric_limits<int>::max(), trades.get());
+            server->GetAccountsByGroup(group_mask, &accounts);
+        } catch (const std::exception& e) {
+            std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+            is_seeded = false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto it = _partitions.find(group_mask);
+        if (it == _partitions.end()) {
+            // Cleared while seeding
+            return nullptr;
+        }
+        if (!is_seeded) {
+            _partitions.erase(it);
+            return nullptr;
+        }
+
+        Partition& partition = it->second;
+        partition.trades     = std::move(trades);
+        partition.position_by_order.reserve(partition.trades->size());
+        for (size_t i = 0; i < partition.trades->size(); ++i) {
+            partition.position_by_order[(*partition.trades)[i].order] = i;
+        }
+        for (const auto& account : accounts) {
+            partition.member_logins.insert(account.login);
+        }
+        for (const auto& trade : *partition.trades) {
+            partition.member_logins.insert(trade.login);
+        }
+
+        partition.is_seeding = false;
+        partition.seeded_at  = Clock::now();
+
+        // Upserts and deletes are idempotent by order, so replaying events the seed already
+        // reflects is harmless
+        for (const auto& event : partition.backlog) {
+            Apply(partition, event);
+        }
+        partition.backlog.clear();
+        partition.backlog.shrink_to_fit();
+
+        return partition.unresolved.empty() ? partition.trades : nullptr;
+    }
+
+    void PendingTradesView::ResolveLogins(ReportServerInterface* server,
+                                          const std::string&     group_mask) {
+        std::vector<ReportAccountRecord> accounts;
+
+        try {
+            server->GetAccountsByGroup(group_mask, &accounts);
+        } catch (const std::exception& e) {
+            std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto it = _partitions.find(group_mask);
+        if (it == _partitions.end() || it->second.is_seeding) {
+            return;
+        }
+
+        Partition& partition = it->second;
+        for (const auto& account : accounts) {
+            partition.member_logins.insert(account.login);
+        }
+
+        std::vector<Event> unresolved;
+        unresolved.swap(partition.unresolved);
+        for (const auto& event : unresolved) {
+            if (partition.member_logins.count(event.trade.login) == 0) {
+                partition.foreign_logins.insert(event.trade.login);
+            }
+            Apply(partition, event);
+        }
+    }
+
+    void PendingTradesView::Apply(Partition& partition, const Event& event) {
+        const ReportTradeRecord& trade = event.trade;
+
+        switch (event.record_type) {
+            case EV_RECORD_ADD:
+            case EV_RECORD_UPDATE:
+            case EV_RECORD_RESTORE:
+                if (!IsPendingCommand(trade.cmd)) {
+                    // Modified into a market order
+                    Erase(partition, trade.order);
+                } else if (partition.member_logins.count(trade.login) > 0) {
+                    Upsert(partition, trade);
+                } else if (partition.foreign_logins.count(trade.login) == 0) {
+                    partition.unresolved.push_back(event);
+                } else {
+                    // Login moved out of the mask
+                    Erase(partition, trade.order);
+                }
+                break;
+            case EV_RECORD_DELETE:
+            case EV_RECORD_ARCHIVE:
+            case EV_RECORD_ACTIVATE_TRADE:
+            case EV_RECORD_CLOSE_TRADE:
+                Erase(partition, trade.order);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void PendingTradesView::Upsert(Partition& partition, const ReportTradeRecord& trade) {
+        Trades& trades = Mutable(partition);
+
+        const auto [it, inserted] = partition.position_by_order.try_emplace(trade.order, trades.size());
+        if (inserted) {
+            trades.push_back(trade);
+        } else {
+            trades[it->second] = trade;
+        }
+    }
+
+    void PendingTradesView::Erase(Partition& partition, const int order) {
+        const auto it = partition.position_by_order.find(order);
+        if (it == partition.position_by_order.end()) {
+            return;
+        }
+
+        Trades&      trades   = Mutable(partition);
+        const size_t position = it->second;
+        partition.position_by_order.erase(it);
+
+        if (position + 1 != trades.size()) {
+            trades[position]                                    = std::move(trades.back());
+            partition.position_by_order[trades[position].order] = position;
+        }
+        trades.pop_back();
+    }
+
+    PendingTradesView::Trades& PendingTradesView::Mutable(Partition& partition) {
+        if (partition.trades.use_count() > 1) {
+            partition.trades = std::make_shared<Trades>(*partition.trades);
+        }
+        return *partition.trades;
+    }
+} // namespace report
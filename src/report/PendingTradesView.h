@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Plugin-side materialized view of pending orders per group mask. A partition is seeded
+    // once from GetPendingTradesByGroup and then kept current from trade events, so reports
+    // query the view instead of re-pulling the whole group.
+    //
+    // The view only serves once the host has delivered a trade event: without an event feed it
+    // would go stale, and reports keep fetching from the server.
+    class PendingTradesView {
+    public:
+        using Trades   = std::vector<ReportTradeRecord>;
+        using Snapshot = std::shared_ptr<const Trades>;
+
+        // Partitions are re-seeded after this long, to pick up changes no event reports
+        // (accounts moved between groups, missed events)
+        static constexpr std::chrono::minutes RESEED_INTERVAL{5};
+
+        static PendingTradesView& Instance();
+
+        // Every pending order of the group mask, regardless of open time. Returns nullptr when
+        // the view is not live or the partition could not be seeded.
+        Snapshot Query(ReportServerInterface* server, const std::string& group_mask);
+
+        void OnTradeEvent(int record_type, const ReportTradeRecord& trade);
+
+        void Clear();
+
+        [[nodiscard]] bool IsLive() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Event {
+            int               record_type = 0;
+            ReportTradeRecord trade;
+        };
+
+        struct Partition {
+            // Copy-on-write: snapshots handed to reports are never mutated
+            std::shared_ptr<Trades>      trades;
+            std::unordered_map<int, size_t> position_by_order;
+
+            // Logins known to be inside / outside the mask
+            std::unordered_set<int> member_logins;
+            std::unordered_set<int> foreign_logins;
+
+            // Events of logins not classified yet, applied once the mask members are refreshed
+            std::vector<Event> unresolved;
+
+            // Events received while the seed fetch is in flight, replayed on top of it
+            bool               is_seeding = false;
+            std::vector<Event> backlog;
+
+            Clock::time_point seeded_at;
+        };
+
+        mutable std::mutex                         _mutex;
+        bool                                       _is_live = false;
+        std::unordered_map<std::string, Partition> _partitions;
+
+        Snapshot Seed(ReportServerInterface* server, const std::string& group_mask);
+        void     ResolveLogins(ReportServerInterface* server, const std::string& group_mask);
+
+        static void Apply(Partition& partition, const Event& event);
+        static void Upsert(Partition& partition, const ReportTradeRecord& trade);
+        static void Erase(Partition& partition, int order);
+        static Trades& Mutable(Partition& partition);
+    };
+} // namespace report
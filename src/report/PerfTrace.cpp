@@ -0,0 +1,247 @@
+#include "PerfTrace.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#include "Allocators.h"
+
+namespace report {
+    namespace {
+        constexpr const char* PHASE_NAMES[] = {"request",
+                                               "cache_lookup",
+                                               "fetch_trades",
+                                               "fetch_groups",
+                                               "setup",
+                                               "filter",
+                                               "accounts",
+                                               "rates",
+                                               "totals",
+                                               "sort",
+                                               "table_props",
+                                               "create_ui",
+                                               "cache_put",
+                                               "export"};
+
+        constexpr const char* COUNTER_NAMES[] = {"rows_fetched",
+                                                 "fetch_partitions",
+                                                 "rows_filtered",
+                                                 "rows_emitted",
+                                                 "server_calls",
+                                                 "allocated_bytes",
+                                                 "allocator_chunks",
+                                                 "cache_hits",
+                                                 "view_hits",
+                                                 "rate_cache_hits"};
+
+        static_assert(std::size(PHASE_NAMES) == static_cast<size_t>(PerfPhase::Count));
+        static_assert(std::size(COUNTER_NAMES) == static_cast<size_t>(PerfCounter::Count));
+
+        bool IsEnabledByEnvironment() {
+            static const bool enabled = [] {
+                const char* value = std::getenv("PENDING_TRADES_PERF");
+                return value != nullptr && *value != '\0' && std::strcmp(value, "0") != 0;
+            }();
+            return enabled;
+        }
+
+        double ToMilliseconds(const std::chrono::steady_clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+    } // namespace
+
+    const char* GetPerfPhaseName(const PerfPhase phase) {
+        return PHASE_NAMES[static_cast<size_t>(phase)];
+    }
+
+    const char* GetPerfCounterName(const PerfCounter counter) {
+        return COUNTER_NAMES[static_cast<size_t>(counter)];
+    }
+
+    PerfTrace::PerfTrace(const rapidjson::Value&                   request,
+                         const rapidjson::Document::AllocatorType& allocator) {
+        _enabled = IsEnabledByEnvironment();
+        if (!_enabled && request.IsObject()) {
+            const auto it = request.FindMember("perf");
+            _enabled      = it != request.MemberEnd() && it->value.IsBool() && it->value.GetBool();
+        }
+
+        if (_enabled) {
+            _allocator_size     = allocator.Size();
+            _allocator_capacity = allocator.Capacity();
+            _pool_chunks        = GetPoolChunksCount();
+            _started_at       = Clock::now();
+            _phase_started_at = _started_at;
+        }
+    }
+
+    void PerfTrace::Switch(const PerfPhase phase) {
+        const Clock::time_point now = Clock::now();
+
+        if (_phase != NO_PHASE) {
+            _durations[_phase] += now - _phase_started_at;
+        }
+
+        _phase            = static_cast<size_t>(phase);
+        _entered[_phase]  = true;
+        _phase_started_at = now;
+    }
+
+    void PerfTrace::Finish(rapidjson::Value&                   response,
+                           rapidjson::Document::AllocatorType& allocator) {
+        if (!_enabled) {
+            return;
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (_phase != NO_PHASE) {
+            _durations[_phase] += now - _phase_started_at;
+            _phase = NO_PHASE;
+        }
+        _counters[static_cast<size_t>(PerfCounter::AllocatedBytes)] +=
+            allocator.Size() - _allocator_size;
+        _counters[static_cast<size_t>(PerfCounter::AllocatorChunks)] +=
+            AllocatorChunksCount(allocator.Capacity() - _allocator_capacity) +
+            (GetPoolChunksCount() - _pool_chunks);
+
+        PerfHistograms& histograms = PerfHistograms::Instance();
+        histograms.AddReport(now - _started_at);
+
+        rapidjson::Value phases(rapidjson::kObjectType);
+        for (size_t i = 0; i < _durations.size(); ++i) {
+            if (!_entered[i]) {
+                continue;
+            }
+            histograms.Add(static_cast<PerfPhase>(i), _durations[i]);
+            phases.AddMember(rapidjson::StringRef(PHASE_NAMES[i]),
+                             ToMilliseconds(_durations[i]),
+                             allocator);
+        }
+
+        rapidjson::Value counters(rapidjson::kObjectType);
+        for (size_t i = 0; i < _counters.size(); ++i) {
+            histograms.Add(static_cast<PerfCounter>(i), _counters[i]);
+            counters.AddMember(rapidjson::StringRef(COUNTER_NAMES[i]),
+                               static_cast<uint64_t>(_counters[i]),
+                               allocator);
+        }
+
+        rapidjson::Value cumulative(rapidjson::kObjectType);
+        histograms.Write(cumulative, allocator);
+
+        rapidjson::Value perf(rapidjson::kObjectType);
+        perf.AddMember("total_ms", ToMilliseconds(now - _started_at), allocator);
+        perf.AddMember("phases_ms", phases, allocator);
+        perf.AddMember("counters", counters, allocator);
+        perf.AddMember("histograms", cumulative, allocator);
+
+        if (!response.IsObject()) {
+            response.SetObject();
+        }
+        response.RemoveMember("perf");
+        response.AddMember("perf", perf, allocator);
+    }
+
+    PerfHistograms& PerfHistograms::Instance() {
+        static PerfHistograms instance;
+        return instance;
+    }
+
+    void PerfHistograms::AddReport(const std::chrono::steady_clock::duration total) {
+        _total.Add(total);
+    }
+
+    void PerfHistograms::Add(const PerfPhase                             phase,
+                             const std::chrono::steady_clock::duration duration) {
+        _phases[static_cast<size_t>(phase)].Add(duration);
+    }
+
+    void PerfHistograms::Add(const PerfCounter counter, const uint64_t value) {
+        _counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void PerfHistograms::Write(rapidjson::Value&                   out,
+                               rapidjson::Document::AllocatorType& allocator) const {
+        out.SetObject();
+
+        rapidjson::Value total(rapidjson::kObjectType);
+        _total.Write(total, allocator);
+        out.AddMember("total", total, allocator);
+
+        rapidjson::Value phases(rapidjson::kObjectType);
+        for (size_t i = 0; i < _phases.size(); ++i) {
+            if (_phases[i].count.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            rapidjson::Value phase(rapidjson::kObjectType);
+            _phases[i].Write(phase, allocator);
+            phases.AddMember(rapidjson::StringRef(PHASE_NAMES[i]), phase, allocator);
+        }
+        out.AddMember("phases", phases, allocator);
+
+        rapidjson::Value counters(rapidjson::kObjectType);
+        for (size_t i = 0; i < _counters.size(); ++i) {
+            counters.AddMember(rapidjson::StringRef(COUNTER_NAMES[i]),
+                               static_cast<uint64_t>(_counters[i].load(std::memory_order_relaxed)),
+                               allocator);
+        }
+        out.AddMember("counters", counters, allocator);
+    }
+
+    void PerfHistograms::Clear() {
+        _total.Clear();
+        for (auto& phase : _phases) {
+            phase.Clear();
+        }
+        for (auto& counter : _counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void PerfHistograms::Histogram::Add(const std::chrono::steady_clock::duration duration) {
+        const auto nanoseconds  = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+        const auto microseconds = static_cast<uint64_t>(nanoseconds.count() / 1000);
+
+        // Bucket i holds [2^(i-1), 2^i) microseconds, bucket 0 holds sub-microsecond phases
+        const size_t bucket = std::min<size_t>(std::bit_width(microseconds), BUCKETS_COUNT - 1);
+
+        count.fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(static_cast<uint64_t>(nanoseconds.count()), std::memory_order_relaxed);
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void PerfHistograms::Histogram::Write(rapidjson::Value&                   out,
+                                          rapidjson::Document::AllocatorType& allocator) const {
+        out.SetObject();
+        out.AddMember("count",
+                      static_cast<uint64_t>(count.load(std::memory_order_relaxed)),
+                      allocator);
+        out.AddMember("total_ms",
+                      static_cast<double>(total_ns.load(std::memory_order_relaxed)) / 1e6,
+                      allocator);
+
+        // Non-empty buckets as [upper bound in microseconds, count]
+        rapidjson::Value bucket_array(rapidjson::kArrayType);
+        for (size_t i = 0; i < BUCKETS_COUNT; ++i) {
+            const uint64_t bucket_count = buckets[i].load(std::memory_order_relaxed);
+            if (bucket_count == 0) {
+                continue;
+            }
+            rapidjson::Value bucket(rapidjson::kArrayType);
+            bucket.PushBack(static_cast<uint64_t>((uint64_t{1} << i) - 1), allocator);
+            bucket.PushBack(bucket_count, allocator);
+            bucket_array.PushBack(bucket, allocator);
+        }
+        out.AddMember("buckets_us", bucket_array, allocator);
+    }
+
+    void PerfHistograms::Histogram::Clear() {
+        count.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+} // namespace report
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <rapidjson/document.h>
+
+namespace report {
+    // Report phases in execution order. A phase may be entered more than once, its time adds up.
+    enum class PerfPhase : uint8_t {
+        Request,
+        CacheLookup,
+        FetchTrades,
+        FetchGroups,
+        Setup,
+        Filter,
+        Accounts,
+        Rates,
+        Totals,
+        Sort,
+        TableProps,
+        CreateUI,
+        CachePut,
+        Export,
+        Count
+    };
+
+    enum class PerfCounter : uint8_t {
+        RowsFetched,
+        FetchPartitions, // server calls the requested range was split into
+        RowsFiltered,
+        RowsEmitted,
+        ServerCalls,
+        AllocatedBytes,  // growth of the response allocator over the report
+        AllocatorChunks, // chunks taken by the response allocator and the plugin-owned pools
+        CacheHits,
+        ViewHits,
+        RateCacheHits, // conversion rates taken from the RateCache instead of the server
+        Count
+    };
+
+    // Opt-in per-report instrumentation, enabled by `perf: true` in the request or by a non-zero
+    // PENDING_TRADES_PERF environment variable. Phases are entered one after another, each
+    // Enter() closes the previous phase. A disabled trace costs a single branch per call.
+    class PerfTrace {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        PerfTrace(const rapidjson::Value&                   request,
+                  const rapidjson::Document::AllocatorType& allocator);
+
+        [[nodiscard]] bool Enabled() const { return _enabled; }
+
+        void Enter(const PerfPhase phase) {
+            if (_enabled) {
+                Switch(phase);
+            }
+        }
+
+        void Add(const PerfCounter counter, const uint64_t value) {
+            if (_enabled) {
+                _counters[static_cast<size_t>(counter)] += value;
+            }
+        }
+
+        // Closes the current phase, adds the `perf` object to the response and accumulates the
+        // process-wide histograms
+        void Finish(rapidjson::Value& response, rapidjson::Document::AllocatorType& allocator);
+
+    private:
+        static constexpr size_t NO_PHASE = static_cast<size_t>(PerfPhase::Count);
+
+        bool              _enabled            = false;
+        size_t            _allocator_size     = 0;
+        size_t            _allocator_capacity = 0;
+        uint64_t          _pool_chunks        = 0;
+        Clock::time_point _started_at;
+        Clock::time_point _phase_started_at;
+        size_t            _phase = NO_PHASE;
+
+        std::array<Clock::duration, static_cast<size_t>(PerfPhase::Count)> _durations{};
+        std::array<bool, static_cast<size_t>(PerfPhase::Count)>            _entered{};
+        std::array<uint64_t, static_cast<size_t>(PerfCounter::Count)>      _counters{};
+
+        void Switch(PerfPhase phase);
+    };
+
+    // Process-wide cumulative histograms of traced reports: per phase latency in log2
+    // microsecond buckets, plus counter totals. Lock-free, updated by every finished trace.
+    class PerfHistograms {
+    public:
+        static constexpr size_t BUCKETS_COUNT = 32;
+
+        static PerfHistograms& Instance();
+
+        void AddReport(std::chrono::steady_clock::duration total);
+        void Add(PerfPhase phase, std::chrono::steady_clock::duration duration);
+        void Add(PerfCounter counter, uint64_t value);
+
+        void Write(rapidjson::Value& out, rapidjson::Document::AllocatorType& allocator) const;
+
+        void Clear();
+
+    private:
+        struct Histogram {
+            std::atomic<uint64_t>                             count{0};
+            std::atomic<uint64_t>                             total_ns{0};
+            std::array<std::atomic<uint64_t>, BUCKETS_COUNT> buckets{};
+
+            void Add(std::chrono::steady_clock::duration duration);
+            void Write(rapidjson::Value& out, rapidjson::Document::AllocatorType& allocator) const;
+            void Clear();
+        };
+
+        Histogram                                                          _total;
+        std::array<Histogram, static_cast<size_t>(PerfPhase::Count)>       _phases;
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(PerfCounter::Count)> _counters{};
+    };
+
+    const char* GetPerfPhaseName(PerfPhase phase);
+    const char* GetPerfCounterName(PerfCounter counter);
+} // namespace report
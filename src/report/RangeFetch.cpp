@@ -0,0 +1,121 @@
+#include "RangeFetch.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "WorkerPool.h"
+
+namespace report {
+    namespace {
+        constexpr time_t SECONDS_PER_DAY = 86'400;
+
+        time_t FloorToDay(const time_t time) {
+            return time - ((time % SECONDS_PER_DAY) + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+        }
+
+        bool IsBefore(const ReportTradeRecord& lhs, const ReportTradeRecord& rhs) {
+            return lhs.order < rhs.order;
+        }
+
+        // Servers return ascending tickets; anything else is ordered here, so that the merge
+        // below sees sorted partitions
+        void SortByOrder(std::vector<ReportTradeRecord>& trades) {
+            if (!std::is_sorted(trades.begin(), trades.end(), IsBefore)) {
+                std::stable_sort(trades.begin(), trades.end(), IsBefore);
+            }
+        }
+    } // namespace
+
+    std::vector<TimePartition> SplitIntoDays(const time_t from,
+                                             const time_t to,
+                                             const size_t max_partitions) {
+        const time_t first_day = FloorToDay(from);
+        const time_t last_day  = FloorToDay(to);
+        if (to <= from || first_day == last_day) {
+            return {{from, to}};
+        }
+
+        const auto days      = static_cast<size_t>((last_day - first_day) / SECONDS_PER_DAY) + 1;
+        const auto limit     = std::max<size_t>(max_partitions, 1);
+        const auto span_days = (days + limit - 1) / limit;
+        const auto span      = static_cast<time_t>(span_days) * SECONDS_PER_DAY;
+
+        std::vector<TimePartition> partitions;
+        partitions.reserve((days + span_days - 1) / span_days);
+        for (time_t begin = first_day; begin <= last_day; begin += span) {
+            partitions.push_back({std::max(begin, from), std::min(begin + span - 1, to)});
+        }
+        return partitions;
+    }
+
+    bool FetchPendingTrades(ReportServerInterface*            server,
+                            const std::string&                group_mask,
+                            const std::vector<TimePartition>& partitions,
+                            std::vector<ReportTradeRecord>&   trades) {
+        std::vector<std::vector<ReportTradeRecord>> fetched(partitions.size());
+        std::vector<uint8_t>                        is_failed(partitions.size(), 0);
+
+        // Server calls dominate; each partition is one call on a worker
+        WorkerPool::Instance().ParallelFor(partitions.size(), [&](const size_t partition) {
+            try {
+                server->GetPendingTradesByGroup(group_mask,
+                                                partitions[partition].from,
+                                                partitions[partition].to,
+                                                &fetched[partition]);
+            } catch (const std::exception& e) {
+                std::cerr << "[PendingTradesReportInterface]: " << e.what() << std::endl;
+                is_failed[partition] = 1;
+            }
+        });
+
+        const bool is_fetched = std::find(is_failed.begin(), is_failed.end(), 1) == is_failed.end();
+
+        for (auto& partition : fetched) {
+            SortByOrder(partition);
+        }
+
+        // Rows of a single partition (a single call, or a range where only one day has pending
+        // orders) are taken without a copy
+        size_t total_count     = 0;
+        size_t non_empty_count = 0;
+        for (const auto& partition : fetched) {
+            total_count += partition.size();
+            non_empty_count += partition.empty() ? 0 : 1;
+        }
+
+        if (non_empty_count <= 1) {
+            const auto it = std::find_if(fetched.begin(), fetched.end(), [](const auto& partition) {
+                return !partition.empty();
+            });
+            trades = it != fetched.end() ? std::move(*it) : std::vector<ReportTradeRecord>();
+            return is_fetched;
+        }
+
+        trades.clear();
+        trades.reserve(total_count);
+
+        // k-way merge, k is at most the workers count. Ties go to the earliest partition and equal
+        // tickets end up adjacent, so a repeated order is the one just taken.
+        std::vector<size_t> heads(fetched.size(), 0);
+        while (true) {
+            size_t next = fetched.size();
+            for (size_t partition = 0; partition < fetched.size(); ++partition) {
+                if (heads[partition] < fetched[partition].size() &&
+                    (next == fetched.size() ||
+                     IsBefore(fetched[partition][heads[partition]], fetched[next][heads[next]]))) {
+                    next = partition;
+                }
+            }
+            if (next == fetched.size()) {
+                break;
+            }
+
+            ReportTradeRecord& trade = fetched[next][heads[next]++];
+            if (trades.empty() || trades.back().order != trade.order) {
+                trades.push_back(std::move(trade));
+            }
+        }
+
+        return is_fetched;
+    }
+} // namespace report
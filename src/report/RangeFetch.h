@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Inclusive [from, to] slice of the requested range, fetched with one server call
+    struct TimePartition {
+        time_t from = 0;
+        time_t to   = 0;
+    };
+
+    // Splits [from, to] at UTC midnights (multiples of a day since the epoch). These are not the
+    // local days FormatTimestamp prints open times in; the bounds only spread the fetch and never
+    // show in the output. Ranges of more than `max_partitions` days get partitions of several
+    // whole days each. A range within one UTC day, or an empty one, is a single partition with
+    // the original bounds.
+    std::vector<TimePartition> SplitIntoDays(time_t from, time_t to, size_t max_partitions);
+
+    // Fills `trades` with the pending trades of the group mask opened in the partitions, fetched
+    // one partition per task on the worker pool and merged by order ticket, so the rows do not
+    // depend on the partitioning: servers return ascending tickets, and the result is then the
+    // one of a single call. An order returned by several partitions is kept once, from the first
+    // of them. Returns false when a partition failed; the trades of the others are still
+    // returned.
+    bool FetchPendingTrades(ReportServerInterface*            server,
+                            const std::string&                group_mask,
+                            const std::vector<TimePartition>& partitions,
+                            std::vector<ReportTradeRecord>&   trades);
+} // namespace report
@@ -0,0 +1,219 @@
+#include "ReportRequest.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string_view>
+
+namespace report {
+    namespace {
+        std::optional<double> GetNumber(const rapidjson::Value& request, const char* name) {
+            if (request.IsObject() && request.HasMember(name) && request[name].IsNumber()) {
+                return request[name].GetDouble();
+            }
+            return std::nullopt;
+        }
+
+        // Request numbers are doubles: values outside the target type are clamped into it, a NaN
+        // is treated as missing
+        template <typename T>
+        std::optional<T> ClampNumber(const std::optional<double> value,
+                                     const T min = std::numeric_limits<T>::lowest(),
+                                     const T max = std::numeric_limits<T>::max()) {
+            if (!value || std::isnan(*value)) {
+                return std::nullopt;
+            }
+            if (*value <= static_cast<double>(min)) {
+                return min;
+            }
+            if (*value >= static_cast<double>(max)) {
+                return max;
+            }
+            return static_cast<T>(*value);
+        }
+
+        bool IsString(const rapidjson::Value& request, const char* name, const std::string_view value) {
+            return request.IsObject() && request.HasMember(name) && request[name].IsString() &&
+                   std::string_view(request[name].GetString(), request[name].GetStringLength()) ==
+                       value;
+        }
+
+        std::optional<SortKey> ParseSortKey(const rapidjson::Value& pair) {
+            if (!pair.IsArray() || pair.Empty() || !pair[0].IsString()) {
+                return std::nullopt;
+            }
+
+            SortKey key;
+            key.column = pair[0].GetString();
+            if (pair.Size() > 1 && pair[1].IsString()) {
+                key.descending = std::string(pair[1].GetString()) != "ASC";
+            }
+            return key;
+        }
+
+        void AppendFilterValue(const rapidjson::Value& value, std::vector<std::string>& values) {
+            if (value.IsString()) {
+                values.emplace_back(value.GetString(), value.GetStringLength());
+            } else if (value.IsNumber()) {
+                char buffer[32];
+                const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value.GetDouble());
+                values.emplace_back(buffer, ec == std::errc() ? end : buffer);
+            } else if (value.IsBool()) {
+                values.emplace_back(value.GetBool() ? "true" : "false");
+            }
+        }
+
+        std::optional<FilterCondition> ParseFilter(const rapidjson::Value& column,
+                                                   const rapidjson::Value& state) {
+            FilterCondition filter;
+            filter.column = column.GetString();
+
+            // Shorthand: {"column": value} - the column's default search
+            const rapidjson::Value* value = &state;
+
+            if (state.IsObject()) {
+                if (state.HasMember("search_type") && state["search_type"].IsString()) {
+                    filter.search_type = state["search_type"].GetString();
+                }
+                if (state.HasMember("mode") && state["mode"].IsString()) {
+                    filter.mode = state["mode"].GetString();
+                }
+                value = state.HasMember("value") ? &state["value"] : nullptr;
+            }
+
+            if (value && value->IsArray()) {
+                for (const auto& item : value->GetArray()) {
+                    AppendFilterValue(item, filter.values);
+                }
+            } else if (value) {
+                AppendFilterValue(*value, filter.values);
+            }
+
+            if (filter.values.empty()) {
+                return std::nullopt;
+            }
+            return filter;
+        }
+    } // namespace
+
+    ReportRequest ReportRequest::Parse(const rapidjson::Value& request) {
+        ReportRequest result;
+
+        if (request.IsObject() && request.HasMember("group") && request["group"].IsString()) {
+            result.group_mask = request["group"].GetString();
+        }
+        if (const auto from = ClampNumber<time_t>(GetNumber(request, "from"))) {
+            result.from = *from;
+        }
+        if (const auto to = ClampNumber<time_t>(GetNumber(request, "to"))) {
+            result.to = *to;
+        }
+        if (const auto offset = ClampNumber<size_t>(GetNumber(request, "offset"), 0, MAX_ROWS)) {
+            result.offset = *offset;
+        }
+        if (const auto limit = GetNumber(request, "limit"); limit && *limit >= 0) {
+            result.limit = ClampNumber<size_t>(limit, 0, MAX_ROWS);
+        }
+        if (const auto cursor = ClampNumber<int>(GetNumber(request, "cursor"))) {
+            result.cursor = *cursor;
+        }
+        if (request.IsObject() && request.HasMember("orderBy") && request["orderBy"].IsArray()) {
+            const rapidjson::Value& order_by = request["orderBy"];
+            if (const auto key = ParseSortKey(order_by)) {
+                result.sort.push_back(*key);
+            } else {
+                for (const auto& pair : order_by.GetArray()) {
+                    if (const auto pair_key = ParseSortKey(pair)) {
+                        result.sort.push_back(*pair_key);
+                    }
+                }
+            }
+        }
+
+        if (request.IsObject() && request.HasMember("currency") && request["currency"].IsString() &&
+            request["currency"].GetStringLength() > 0) {
+            result.currency = request["currency"].GetString();
+        }
+
+        if (request.IsObject() && request.HasMember("cache") && request["cache"].IsBool()) {
+            result.use_cache = request["cache"].GetBool();
+        }
+        if (request.IsObject() && request.HasMember("filters") && request["filters"].IsObject()) {
+            for (const auto& member : request["filters"].GetObject()) {
+                if (auto filter = ParseFilter(member.name, member.value)) {
+                    result.filters.push_back(std::move(*filter));
+                }
+            }
+        }
+
+        if (IsString(request, "format", "csv")) {
+            result.format         = OutputFormat::Csv;
+            result.export_to_file = IsString(request, "output", "file");
+        } else if (IsString(request, "format", "columnar")) {
+            result.format         = OutputFormat::Columnar;
+            result.export_to_file = true;
+        }
+
+        if (result.format != OutputFormat::Ui) {
+            // An export covers every filtered row
+            result.offset    = 0;
+            result.limit     = std::nullopt;
+            result.cursor    = std::nullopt;
+            result.use_cache = false;
+        }
+
+        return result;
+    }
+
+    std::vector<SortKey> ReportRequest::GetEffectiveSort() const {
+        if (!sort.empty() || !IsPaginated()) {
+            return sort;
+        }
+        return {SortKey{"order", true}};
+    }
+
+    std::string ReportRequest::GetCacheKey() const {
+        // Length-prefixed fields, so values cannot run into each other
+        std::string key;
+        const auto  append = [&key](const std::string& value) {
+            key += std::to_string(value.size());
+            key += ':';
+            key += value;
+        };
+
+        append(group_mask);
+        append(std::to_string(from));
+        append(std::to_string(to));
+        append(std::to_string(offset));
+        append(limit ? std::to_string(*limit) : "-");
+        append(cursor ? std::to_string(*cursor) : "-");
+        append(currency);
+
+        for (const auto& key_column : GetEffectiveSort()) {
+            append(key_column.column);
+            append(key_column.descending ? "DESC" : "ASC");
+        }
+        key += '|';
+
+        // Filter order in the request does not change the result
+        std::vector<const FilterCondition*> sorted_filters;
+        for (const auto& filter : filters) {
+            sorted_filters.push_back(&filter);
+        }
+        std::sort(sorted_filters.begin(), sorted_filters.end(), [](const auto* lhs, const auto* rhs) {
+            return lhs->column < rhs->column;
+        });
+        for (const auto* filter : sorted_filters) {
+            append(filter->column);
+            append(filter->search_type);
+            append(filter->mode);
+            append(std::to_string(filter->values.size()));
+            for (const auto& value : filter->values) {
+                append(value);
+            }
+        }
+
+        return key;
+    }
+} // namespace report
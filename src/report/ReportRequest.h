@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <rapidjson/document.h>
+#include <string>
+#include <vector>
+
+namespace report {
+    struct SortKey {
+        std::string column;
+        bool        descending = true;
+    };
+
+    // Filter state of one column as sent by the table UI
+    struct FilterCondition {
+        std::string              column;
+        std::string              search_type; // "like", "between", ... empty - column default
+        std::string              mode;        // "number" / "string", empty - column default
+        std::vector<std::string> values;      // operands as text, numbers included
+    };
+
+    enum class OutputFormat {
+        Ui,      // table UI tree
+        Csv,     // CSV export of every filtered row
+        Columnar // binary columnar file of every filtered row, see ColumnarExport
+    };
+
+    // Parameters of a CreateReport call, read once from the request object
+    struct ReportRequest {
+        // Rows are addressed by 32-bit indices; `offset` and `limit` are clamped to this
+        static constexpr size_t MAX_ROWS = UINT32_MAX;
+
+        std::string group_mask;
+        time_t      from = 0;
+        time_t      to   = 0;
+
+        // Pagination: rows [offset, offset + limit) of the ordered set. Without an offset, limit
+        // or cursor the whole set is returned in server order, as before pagination existed.
+        size_t                offset = 0;
+        std::optional<size_t> limit;
+
+        // Keyset cursor on `order`: only rows past this order (in table order) are returned.
+        // Applies when the primary sort key is `order`.
+        std::optional<int> cursor;
+
+        // Server-side ordering, `orderBy` as ["column", "DESC"] or a list of such pairs
+        std::vector<SortKey> sort;
+
+        // Server-side filtering, `filters` as {"column": {"search_type", "mode", "value"}}
+        std::vector<FilterCondition> filters;
+
+        // `currency`: money columns are converted into it, rows of accounts already in it are
+        // left as they are
+        std::string currency = "USD";
+
+        // `cache: false` bypasses the result cache
+        bool use_cache = true;
+
+        // `format: "csv"` / `"columnar"` exports the whole filtered set in table order instead of
+        // building the UI; pagination and the result cache do not apply. With `output: "file"` the
+        // CSV is streamed into a temporary file and only its path is returned, a columnar export
+        // is always a file.
+        OutputFormat format         = OutputFormat::Ui;
+        bool         export_to_file = false;
+
+        // An offset alone paginates too: the skipped rows must come from the table order, and
+        // the client needs the offset and total to tell that rows were skipped
+        [[nodiscard]] bool IsPaginated() const {
+            return offset > 0 || limit.has_value() || cursor.has_value();
+        }
+
+        // Sort keys to apply: the requested ones, or the table's default when paginating
+        [[nodiscard]] std::vector<SortKey> GetEffectiveSort() const;
+
+        // Normalized form of every option that affects the response
+        [[nodiscard]] std::string GetCacheKey() const;
+
+        static ReportRequest Parse(const rapidjson::Value& request);
+    };
+} // namespace report
@@ -0,0 +1,97 @@
+#include "ResultCache.h"
+
+#include <algorithm>
+
+namespace report {
+    ResultCache& ResultCache::Instance() {
+        static ResultCache cache;
+        return cache;
+    }
+
+    bool ResultCache::Get(const std::string&                  key,
+                          rapidjson::Value&                   response,
+                          rapidjson::Document::AllocatorType& allocator) {
+        std::shared_ptr<const Payload> payload;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            const auto it = _entries.find(key);
+            if (it == _entries.end()) {
+                return false;
+            }
+            if (it->second.expires_at <= Clock::now()) {
+                Erase(it);
+                return false;
+            }
+
+            _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+            payload = it->second.payload;
+        }
+
+        // Const strings are copied too: they may point into the cached document's allocator
+        response.CopyFrom(payload->document, allocator, true);
+        return true;
+    }
+
+    void ResultCache::Put(const std::string&      key,
+                          const rapidjson::Value& response,
+                          const size_t            expected_bytes) {
+        // Const strings are copied as well, a little headroom keeps the copy in one chunk
+        const size_t chunk_size = std::max(DEFAULT_CHUNK_SIZE, expected_bytes + expected_bytes / 8);
+        auto         payload    = std::make_shared<Payload>(chunk_size);
+        payload->document.CopyFrom(response, payload->allocator, true);
+        const size_t bytes = payload->allocator.Size();
+        AddPoolChunks(AllocatorChunksCount(payload->allocator.Capacity(), chunk_size));
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (bytes > _max_bytes || _max_entries == 0) {
+            return;
+        }
+
+        if (const auto it = _entries.find(key); it != _entries.end()) {
+            Erase(it);
+        }
+
+        _lru.push_front(key);
+
+        Entry& entry       = _entries[key];
+        entry.payload      = std::move(payload);
+        entry.bytes        = bytes;
+        entry.expires_at   = Clock::now() + _ttl;
+        entry.lru_position = _lru.begin();
+        _total_bytes += bytes;
+
+        Evict();
+    }
+
+    void ResultCache::Clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+        _lru.clear();
+        _total_bytes = 0;
+    }
+
+    void ResultCache::Configure(const std::chrono::milliseconds ttl,
+                                const size_t                    max_bytes,
+                                const size_t                    max_entries) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ttl         = ttl;
+        _max_bytes   = max_bytes;
+        _max_entries = max_entries;
+        Evict();
+    }
+
+    void ResultCache::Erase(const std::unordered_map<std::string, Entry>::iterator it) {
+        _total_bytes -= it->second.bytes;
+        _lru.erase(it->second.lru_position);
+        _entries.erase(it);
+    }
+
+    void ResultCache::Evict() {
+        while (!_lru.empty() && (_total_bytes > _max_bytes || _entries.size() > _max_entries)) {
+            Erase(_entries.find(_lru.back()));
+        }
+    }
+} // namespace report
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <rapidjson/document.h>
+#include <string>
+#include <unordered_map>
+
+#include "Allocators.h"
+
+namespace report {
+    // Process-wide cache of finished report responses keyed by the normalized request.
+    // Entries expire after a TTL and the least recently used ones are evicted once the total
+    // payload size exceeds the bound. A hit copies the cached payload into the caller's
+    // allocator; nothing is fetched, enriched or serialized again.
+    class ResultCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr std::chrono::milliseconds DEFAULT_TTL{10'000};
+        static constexpr size_t                    DEFAULT_MAX_BYTES   = 256 * 1024 * 1024;
+        static constexpr size_t                    DEFAULT_MAX_ENTRIES = 64;
+
+        static ResultCache& Instance();
+
+        // Copies a cached response into `response`; false on miss or expired entry
+        bool Get(const std::string&                  key,
+                 rapidjson::Value&                   response,
+                 rapidjson::Document::AllocatorType& allocator);
+
+        // Stores a copy of `response` under `key`. The copy is made in a pool of its own with a
+        // first chunk of `expected_bytes` (the size of the response, when known).
+        void Put(const std::string& key, const rapidjson::Value& response, size_t expected_bytes);
+
+        void Clear();
+
+        void Configure(std::chrono::milliseconds ttl, size_t max_bytes, size_t max_entries);
+
+    private:
+        // Cached response and the pool it lives in
+        struct Payload {
+            explicit Payload(const size_t chunk_size)
+                : allocator(chunk_size), document(&allocator) {}
+
+            PoolAllocator       allocator;
+            rapidjson::Document document;
+        };
+
+        struct Entry {
+            std::shared_ptr<const Payload>   payload;
+            size_t                           bytes = 0;
+            Clock::time_point                expires_at;
+            std::list<std::string>::iterator lru_position;
+        };
+
+        std::mutex                             _mutex;
+        std::unordered_map<std::string, Entry> _entries;
+        std::list<std::string>                 _lru; // most recently used first
+        size_t                                 _total_bytes = 0;
+
+        std::chrono::milliseconds _ttl         = DEFAULT_TTL;
+        size_t                    _max_bytes   = DEFAULT_MAX_BYTES;
+        size_t                    _max_entries = DEFAULT_MAX_ENTRIES;
+
+        void Erase(std::unordered_map<std::string, Entry>::iterator it);
+        void Evict();
+    };
+} // namespace report
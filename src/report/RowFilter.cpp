@@ -0,0 +1,276 @@
+#include "RowFilter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+
+#include "utils/Utils.h"
+
+namespace report {
+    namespace {
+        std::optional<SearchType> ParseSearchType(const std::string& search_type) {
+            static const std::pair<const char*, SearchType> types[] = {
+                {"like", SearchType::Like},
+                {"equal", SearchType::Equal},
+                {"not_equal", SearchType::NotEqual},
+                {"between", SearchType::Between},
+                {"outside", SearchType::Outside},
+                {"below", SearchType::Below},
+                {"below_or_equal", SearchType::BelowOrEqual},
+                {"above", SearchType::Above},
+                {"above_or_equal", SearchType::AboveOrEqual},
+                {"select", SearchType::Select},
+                {"select_except", SearchType::SelectExcept},
+            };
+
+            for (const auto& [name, type] : types) {
+                if (search_type == name) {
+                    return type;
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::optional<double> ParseNumber(const std::string& text) {
+            char*        end   = nullptr;
+            const double value = std::strtod(text.c_str(), &end);
+            if (end == text.c_str() || *end != '\0') {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        char ToLower(const char c) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+
+        // Case-insensitive substring search, needle already lower-cased
+        bool ContainsIgnoreCase(const std::string_view haystack, const std::string_view needle) {
+            return std::search(haystack.begin(),
+                               haystack.end(),
+                               needle.begin(),
+                               needle.end(),
+                               [](const char lhs, const char rhs) { return ToLower(lhs) == rhs; }) !=
+                   haystack.end();
+        }
+
+        // Conversion rate of a money cell, 1 for every other column
+        double GetRate(const ColumnId           column,
+                       const ReportTradeRecord& trade,
+                       const AccountIndex*      account_index,
+                       const GroupIndex*        group_index,
+                       const ConversionMatrix*  conversion) {
+            if (conversion == nullptr || conversion->IsIdentity() || !IsMoneyColumn(column)) {
+                return 1.0;
+            }
+            return conversion->GetRate(
+                group_index->GetCurrencyId(account_index->Find(trade.login).group), trade.cmd);
+        }
+
+        // Number as displayed in the table (volume in lots, money converted at `rate` and
+        // truncated to cents)
+        double GetNumericValue(const ColumnId           column,
+                               const ReportTradeRecord& trade,
+                               const double             rate = 1.0) {
+            switch (column) {
+                case ColumnId::Order: return trade.order;
+                case ColumnId::Login: return trade.login;
+                case ColumnId::OpenTime: return static_cast<double>(trade.open_time);
+                case ColumnId::Volume: return utils::TruncateDouble(trade.volume / 100.0, 2);
+                case ColumnId::OpenPrice: return utils::TruncateDouble(trade.open_price * rate, 2);
+                case ColumnId::Sl: return utils::TruncateDouble(trade.sl * rate, 2);
+                case ColumnId::Tp: return utils::TruncateDouble(trade.tp * rate, 2);
+                case ColumnId::Storage: return utils::TruncateDouble(trade.storage * rate, 2);
+                case ColumnId::Profit: return utils::TruncateDouble(trade.profit * rate, 2);
+                default: return 0.0;
+            }
+        }
+
+        // Text as displayed in the table; formatted cells are written into `scratch`
+        std::string_view GetTextValue(const ColumnId           column,
+                                      const ReportTradeRecord& trade,
+                                      const AccountIndex*      account_index,
+                                      const GroupIndex*        group_index,
+                                      const ConversionMatrix*  conversion,
+                                      std::string&             scratch) {
+            switch (column) {
+                case ColumnId::Symbol: return trade.symbol;
+                case ColumnId::Comment: return trade.comment;
+                case ColumnId::Type: return GetCommandName(static_cast<int>(trade.cmd));
+                case ColumnId::Name: return account_index->Find(trade.login).name;
+                case ColumnId::Group: return account_index->Find(trade.login).group;
+                case ColumnId::Currency:
+                    return group_index->GetCurrency(
+                        group_index->GetCurrencyId(account_index->Find(trade.login).group));
+                case ColumnId::OpenTime: {
+                    char       buffer[utils::TIMESTAMP_BUFFER_SIZE];
+                    const auto length = utils::FormatTimestamp(trade.open_time, buffer);
+                    scratch.assign(buffer, length);
+                    return scratch;
+                }
+                default: {
+                    char       buffer[32];
+                    const double rate =
+                        GetRate(column, trade, account_index, group_index, conversion);
+                    const auto [end, ec] = std::to_chars(
+                        buffer, buffer + sizeof(buffer), GetNumericValue(column, trade, rate));
+                    scratch.assign(buffer, ec == std::errc() ? end : buffer);
+                    return scratch;
+                }
+            }
+        }
+
+        template <typename Value, typename Operand, typename Less = std::less<>>
+        bool Compare(const SearchType            search_type,
+                     const Value&                value,
+                     const std::vector<Operand>& operands,
+                     const Less&                 less = Less()) {
+            switch (search_type) {
+                case SearchType::Equal:
+                    return !less(value, operands[0]) && !less(operands[0], value);
+                case SearchType::NotEqual:
+                    return less(value, operands[0]) || less(operands[0], value);
+                case SearchType::Between:
+                    return !less(value, operands[0]) && !less(operands[1], value);
+                case SearchType::Outside:
+                    return less(value, operands[0]) || less(operands[1], value);
+                case SearchType::Below: return less(value, operands[0]);
+                case SearchType::BelowOrEqual: return !less(operands[0], value);
+                case SearchType::Above: return less(operands[0], value);
+                case SearchType::AboveOrEqual: return !less(value, operands[0]);
+                case SearchType::Select:
+                    return std::binary_search(operands.begin(), operands.end(), value, less);
+                case SearchType::SelectExcept:
+                    return !std::binary_search(operands.begin(), operands.end(), value, less);
+                case SearchType::Like: return true;
+            }
+            return true;
+        }
+    } // namespace
+
+    RowFilter::RowFilter(const std::vector<FilterCondition>& conditions, const bool is_converted)
+        : _is_converted(is_converted) {
+        for (const auto& condition : conditions) {
+            if (auto predicate = Compile(condition)) {
+                _predicates.push_back(std::move(*predicate));
+            }
+        }
+    }
+
+    bool RowFilter::HasStage(const Stage stage) const {
+        return std::any_of(_predicates.begin(), _predicates.end(), [&](const auto& predicate) {
+            return GetStage(predicate.column) == stage;
+        });
+    }
+
+    void RowFilter::Apply(const Stage                           stage,
+                          const std::vector<ReportTradeRecord>& trades,
+                          std::vector<uint32_t>&                rows,
+                          const AccountIndex*                   account_index,
+                          const GroupIndex*                     group_index,
+                          const ConversionMatrix*               conversion) const {
+        for (const auto& predicate : _predicates) {
+            if (GetStage(predicate.column) != stage) {
+                continue;
+            }
+
+            const auto end = [&] {
+                if (predicate.numeric) {
+                    return std::remove_if(rows.begin(), rows.end(), [&](const uint32_t row) {
+                        const double rate = GetRate(
+                            predicate.column, trades[row], account_index, group_index, conversion);
+                        return !Compare(predicate.search_type,
+                                        GetNumericValue(predicate.column, trades[row], rate),
+                                        predicate.numbers);
+                    });
+                }
+
+                std::string scratch;
+                return std::remove_if(rows.begin(), rows.end(), [&](const uint32_t row) {
+                    const std::string_view text = GetTextValue(predicate.column,
+                                                               trades[row],
+                                                               account_index,
+                                                               group_index,
+                                                               conversion,
+                                                               scratch);
+                    if (predicate.search_type == SearchType::Like) {
+                        // Several values match a row containing any of them, as Select does
+                        return std::none_of(predicate.texts.begin(),
+                                            predicate.texts.end(),
+                                            [&](const std::string& needle) {
+                                                return ContainsIgnoreCase(text, needle);
+                                            });
+                    }
+                    return !Compare(predicate.search_type,
+                                    text,
+                                    predicate.texts,
+                                    [](const std::string_view lhs, const std::string_view rhs) {
+                                        return lhs < rhs;
+                                    });
+                });
+            }();
+
+            rows.erase(end, rows.end());
+        }
+    }
+
+    RowFilter::Stage RowFilter::GetStage(const ColumnId column) const {
+        const bool is_account = IsAccountColumn(column) || (_is_converted && IsMoneyColumn(column));
+        return is_account ? Stage::Account : Stage::Trade;
+    }
+
+    std::optional<RowFilter::Predicate> RowFilter::Compile(const FilterCondition& condition) {
+        Predicate predicate;
+        predicate.column = ParseColumnId(condition.column);
+        if (predicate.column == ColumnId::Unknown || condition.values.empty()) {
+            return std::nullopt;
+        }
+
+        // Columns declare a search filter (like) except open_time, which is a date range
+        const auto search_type = ParseSearchType(condition.search_type);
+        predicate.search_type  = search_type ? *search_type
+                                 : predicate.column == ColumnId::OpenTime ? SearchType::Between
+                                                                          : SearchType::Like;
+
+        const bool numeric_mode =
+            condition.mode.empty() ? IsNumericColumn(predicate.column) : condition.mode == "number";
+        predicate.numeric = numeric_mode && IsNumericColumn(predicate.column) &&
+                            predicate.search_type != SearchType::Like;
+
+        const bool is_range = predicate.search_type == SearchType::Between ||
+                              predicate.search_type == SearchType::Outside;
+        if (is_range && condition.values.size() < 2) {
+            return std::nullopt;
+        }
+
+        if (predicate.numeric) {
+            for (const auto& value : condition.values) {
+                const auto number = ParseNumber(value);
+                if (!number) {
+                    return std::nullopt;
+                }
+                predicate.numbers.push_back(*number);
+            }
+        } else {
+            predicate.texts = condition.values;
+        }
+
+        switch (predicate.search_type) {
+            case SearchType::Like:
+                for (auto& text : predicate.texts) {
+                    std::transform(text.begin(), text.end(), text.begin(), ToLower);
+                }
+                break;
+            case SearchType::Select:
+            case SearchType::SelectExcept:
+                std::sort(predicate.numbers.begin(), predicate.numbers.end());
+                std::sort(predicate.texts.begin(), predicate.texts.end());
+                break;
+            default:
+                break;
+        }
+
+        return predicate;
+    }
+} // namespace report
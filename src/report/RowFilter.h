@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AccountIndex.h"
+#include "CurrencyConversion.h"
+#include "GroupIndex.h"
+#include "ReportRequest.h"
+#include "ReportServerInterface.h"
+#include "TableColumns.h"
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+
+namespace report {
+    // Filter predicates compiled from the request's filter state. Predicates run over a
+    // selection vector of trade indices before rows are enriched or formatted; each one narrows
+    // the selection in a single typed pass.
+    class RowFilter {
+    public:
+        // Trade predicates only need the trade record, account predicates (name, group,
+        // currency, and converted money) need the resolved account and run once accounts are
+        // indexed.
+        enum class Stage { Trade, Account };
+
+        // With `is_converted` money predicates compare converted values and run in the Account
+        // stage, with the conversion rates
+        explicit RowFilter(const std::vector<FilterCondition>& conditions,
+                           bool                                is_converted = false);
+
+        [[nodiscard]] bool Empty() const { return _predicates.empty(); }
+
+        [[nodiscard]] bool HasStage(Stage stage) const;
+
+        // Removes rows not matching the stage's predicates, keeping the order of the rest.
+        // Account predicates need both indices.
+        void Apply(Stage                                 stage,
+                   const std::vector<ReportTradeRecord>& trades,
+                   std::vector<uint32_t>&                rows,
+                   const AccountIndex*                   account_index = nullptr,
+                   const GroupIndex*                     group_index   = nullptr,
+                   const ConversionMatrix*               conversion    = nullptr) const;
+
+    private:
+        struct Predicate {
+            ColumnId                 column      = ColumnId::Unknown;
+            SearchType               search_type = SearchType::Like;
+            bool                     numeric     = false;
+            std::vector<double>      numbers; // sorted for Select/SelectExcept
+            std::vector<std::string> texts;   // lower-cased for Like, sorted for Select
+        };
+
+        std::vector<Predicate> _predicates;
+        bool                   _is_converted = false;
+
+        [[nodiscard]] Stage GetStage(ColumnId column) const;
+
+        // nullopt for an unknown column or operands that do not parse: such a condition is
+        // ignored rather than emptying the report
+        static std::optional<Predicate> Compile(const FilterCondition& condition);
+    };
+} // namespace report
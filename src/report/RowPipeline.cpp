@@ -0,0 +1,175 @@
+#include "RowPipeline.h"
+
+#include <algorithm>
+
+#include "CsvExport.h"
+#include "WorkerPool.h"
+
+namespace report {
+    namespace {
+        constexpr size_t PRICE_COLUMNS = 6;
+
+        // Price cells are truncated column-wise in blocks of this many rows
+        constexpr size_t TRUNCATE_BLOCK_SIZE = 256;
+
+        size_t ChunksCount(const size_t rows_count) {
+            return (rows_count + RowPipeline::CHUNK_SIZE - 1) / RowPipeline::CHUNK_SIZE;
+        }
+    } // namespace
+
+    void RowPipeline::Prepare(const uint32_t* rows,
+                              const size_t    count,
+                              PreparedRow*    prepared) const {
+        const bool is_converted = _conversion != nullptr && !_conversion->IsIdentity();
+
+        double prices[PRICE_COLUMNS][TRUNCATE_BLOCK_SIZE];
+        double rates[TRUNCATE_BLOCK_SIZE];
+
+        for (size_t block_begin = 0; block_begin < count; block_begin += TRUNCATE_BLOCK_SIZE) {
+            const size_t block_size = std::min(TRUNCATE_BLOCK_SIZE, count - block_begin);
+
+            for (size_t i = 0; i < block_size; ++i) {
+                const ReportTradeRecord&   trade       = _trades[rows[block_begin + i]];
+                const ReportAccountRecord& account     = _account_index.Find(trade.login);
+                const CurrencyId           currency_id = _group_index.GetCurrencyId(account.group);
+                PreparedRow&               row         = prepared[block_begin + i];
+
+                row.trade    = &trade;
+                row.account  = &account;
+                row.currency = &_group_index.GetCurrency(currency_id);
+
+                if (is_converted) {
+                    rates[i] = _conversion->GetRate(currency_id, trade.cmd);
+                }
+
+                prices[0][i] = trade.volume / 100.0;
+                prices[1][i] = trade.open_price;
+                prices[2][i] = trade.sl;
+                prices[3][i] = trade.tp;
+                prices[4][i] = trade.storage;
+                prices[5][i] = trade.profit;
+            }
+
+            // Money columns are converted before truncation, as the per-row multiply was;
+            // volume is in lots and stays as it is
+            if (is_converted) {
+                for (size_t column = 1; column < PRICE_COLUMNS; ++column) {
+                    utils::MultiplyDoubles(prices[column], rates, block_size, prices[column]);
+                }
+            }
+
+            for (auto& column : prices) {
+                utils::TruncateDoubles(column, block_size, 2, column);
+            }
+
+            for (size_t i = 0; i < block_size; ++i) {
+                PreparedRow& row = prepared[block_begin + i];
+                for (size_t column = 0; column < PRICE_COLUMNS; ++column) {
+                    row.prices[column] = prices[column][i];
+                }
+                row.open_time_length = static_cast<uint8_t>(
+                    utils::FormatTimestamp(row.trade->open_time, row.open_time));
+            }
+        }
+    }
+
+    void RowPipeline::WriteRow(const PreparedRow& row, RowWriter& writer) {
+        const ReportTradeRecord& trade = *row.trade;
+
+        writer.BeginRow();
+        writer.Number(utils::TruncateDouble(trade.order, 0));
+        writer.Number(utils::TruncateDouble(trade.login, 0));
+        writer.String(row.account->name);
+        writer.String(row.open_time, row.open_time_length);
+        writer.StaticString(utils::ConvertCmdToString(static_cast<int>(trade.cmd)));
+        writer.InternedString(trade.symbol);
+        for (const double price : row.prices) {
+            writer.Number(price);
+        }
+        writer.String(trade.comment);
+        writer.InternedString(*row.currency);
+        writer.InternedString(row.account->group);
+        writer.EndRow();
+    }
+
+    void RowPipeline::Write(const std::vector<uint32_t>& rows, RowWriter& writer) const {
+        // Chunks are prepared ahead on the workers; the writer (rapidjson allocator, CSV
+        // buffer) stays on this thread
+        std::vector<std::vector<PreparedRow>> chunks(ChunksCount(rows.size()));
+
+        WorkerPool::Instance().OrderedFor(
+            chunks.size(),
+            [&](const size_t chunk) {
+                const size_t begin = chunk * CHUNK_SIZE;
+                const size_t count = std::min(CHUNK_SIZE, rows.size() - begin);
+                chunks[chunk].resize(count);
+                Prepare(rows.data() + begin, count, chunks[chunk].data());
+            },
+            [&](const size_t chunk) {
+                for (const PreparedRow& row : chunks[chunk]) {
+                    WriteRow(row, writer);
+                }
+                std::vector<PreparedRow>().swap(chunks[chunk]);
+            });
+    }
+
+    OutputEstimate RowPipeline::Estimate(const std::vector<uint32_t>& rows) const {
+        OutputEstimate estimate;
+        estimate.rows_count = rows.size();
+        if (rows.size() < ESTIMATE_MIN_ROWS) {
+            return estimate;
+        }
+
+        std::vector<uint32_t> sample(ESTIMATE_SAMPLE_SIZE);
+        for (size_t i = 0; i < sample.size(); ++i) {
+            sample[i] = rows[i * rows.size() / sample.size()];
+        }
+
+        std::vector<PreparedRow> prepared(sample.size());
+        Prepare(sample.data(), sample.size(), prepared.data());
+
+        std::string csv;
+        {
+            CsvWriter writer(csv);
+            for (const PreparedRow& row : prepared) {
+                WriteRow(row, writer);
+            }
+        }
+
+        estimate.csv_bytes = csv.size() * rows.size() / sample.size();
+        return estimate;
+    }
+
+    CurrencyTotals RowPipeline::Totals(const std::vector<uint32_t>& rows) const {
+        const size_t                currency_count = _group_index.CurrencyCount();
+        std::vector<CurrencyTotals> partials(ChunksCount(rows.size()));
+
+        WorkerPool::Instance().ParallelFor(partials.size(), [&](const size_t chunk) {
+            CurrencyTotals& partial = partials[chunk];
+            partial.volume.assign(currency_count, 0.0);
+            partial.has_trades.assign(currency_count, false);
+
+            const size_t end = std::min(rows.size(), (chunk + 1) * CHUNK_SIZE);
+            for (size_t i = chunk * CHUNK_SIZE; i < end; ++i) {
+                const ReportTradeRecord&   trade       = _trades[rows[i]];
+                const ReportAccountRecord& account     = _account_index.Find(trade.login);
+                const CurrencyId           currency_id = _group_index.GetCurrencyId(account.group);
+
+                partial.volume[currency_id] += trade.volume;
+                partial.has_trades[currency_id] = true;
+            }
+        });
+
+        // Volumes are integers: the chunked sums are exact and equal the sequential sum
+        CurrencyTotals totals{std::vector<double>(currency_count, 0.0),
+                              std::vector<bool>(currency_count, false)};
+        for (const CurrencyTotals& partial : partials) {
+            for (CurrencyId id = 0; id < currency_count; ++id) {
+                totals.volume[id] += partial.volume[id];
+                totals.has_trades[id] = totals.has_trades[id] || partial.has_trades[id];
+            }
+        }
+
+        return totals;
+    }
+} // namespace report
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AccountIndex.h"
+#include "Allocators.h"
+#include "CurrencyConversion.h"
+#include "GroupIndex.h"
+#include "ReportServerInterface.h"
+#include "sbxTableBuilder/ColumnStore.hpp"
+#include "utils/Utils.h"
+
+namespace report {
+    // Per-currency volume over the filtered rows
+    struct CurrencyTotals {
+        std::vector<double> volume;
+        std::vector<bool>   has_trades;
+    };
+
+    // Row enrichment and formatting. Rows are independent: chunks of them are resolved
+    // (account, currency), formatted (open time), converted and truncated (prices) on the worker
+    // pool, then written to the RowWriter on the calling thread in their original order, so the
+    // output is the same as a sequential pass.
+    class RowPipeline {
+    public:
+        // Rows per task; smaller inputs run inline
+        static constexpr size_t CHUNK_SIZE = 4096;
+
+        // Money columns are multiplied by the `conversion` rates, when given
+        RowPipeline(const std::vector<ReportTradeRecord>& trades,
+                    const AccountIndex&                   account_index,
+                    const GroupIndex&                     group_index,
+                    const ConversionMatrix*               conversion = nullptr)
+            : _trades(trades),
+              _account_index(account_index),
+              _group_index(group_index),
+              _conversion(conversion) {}
+
+        // Writes one table row per index in `rows`
+        void Write(const std::vector<uint32_t>& rows, RowWriter& writer) const;
+
+        // Per-chunk partial totals, summed in chunk order
+        [[nodiscard]] CurrencyTotals Totals(const std::vector<uint32_t>& rows) const;
+
+        // Output size of Write(rows): up to ESTIMATE_SAMPLE_SIZE rows spread over the range are
+        // formatted and measured. Below ESTIMATE_MIN_ROWS only the row count is set, the default
+        // buffers absorb such outputs.
+        [[nodiscard]] OutputEstimate Estimate(const std::vector<uint32_t>& rows) const;
+
+        static constexpr size_t ESTIMATE_SAMPLE_SIZE = 256;
+        static constexpr size_t ESTIMATE_MIN_ROWS    = 1024;
+
+    private:
+        // Everything a row needs from the records, computed off the writer thread
+        struct PreparedRow {
+            const ReportTradeRecord*   trade;
+            const ReportAccountRecord* account;
+            const std::string*         currency;
+            double                     prices[6]; // volume, open_price, sl, tp, storage, profit
+            uint8_t                    open_time_length;
+            char                       open_time[utils::TIMESTAMP_BUFFER_SIZE];
+        };
+
+        const std::vector<ReportTradeRecord>& _trades;
+        const AccountIndex&                   _account_index;
+        const GroupIndex&                     _group_index;
+        const ConversionMatrix*               _conversion;
+
+        void Prepare(const uint32_t* rows, size_t count, PreparedRow* prepared) const;
+
+        static void WriteRow(const PreparedRow& row, RowWriter& writer);
+    };
+} // namespace report
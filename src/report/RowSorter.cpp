@@ -0,0 +1,233 @@
+#include "RowSorter.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include "TableColumns.h"
+
+namespace report {
+    namespace {
+        // Full sorts below this size are cheaper with a comparison sort than with 4+ radix passes
+        constexpr size_t RADIX_SORT_THRESHOLD = 4096;
+
+        // Partial selection pays off while the window is a small part of the rows
+        constexpr size_t PARTIAL_SELECTION_RATIO = 8;
+
+        // Windows up to this size are selected with a bounded heap, larger ones with nth_element
+        constexpr size_t HEAP_SELECTION_LIMIT = 1024;
+
+        // Maps a signed key onto an unsigned one with the same order (reversed for DESC)
+        uint64_t ToRadixKey(const int64_t value, const bool descending) {
+            const uint64_t key = static_cast<uint64_t>(value) ^ (uint64_t{1} << 63);
+            return descending ? ~key : key;
+        }
+    } // namespace
+
+    RowSorter::RowSorter(const std::vector<ReportTradeRecord>& trades,
+                         const AccountIndex&                   account_index,
+                         const GroupIndex&                     group_index,
+                         const ConversionMatrix*               conversion)
+        : _trades(trades),
+          _account_index(account_index),
+          _group_index(group_index),
+          _conversion(conversion) {}
+
+    bool RowSorter::IsSortable(const std::string& column) {
+        return ParseColumnId(column) != ColumnId::Unknown;
+    }
+
+    void RowSorter::Sort(std::vector<uint32_t>&      rows,
+                         const std::vector<SortKey>& keys,
+                         size_t                      limit) const {
+        limit = std::min(limit, rows.size());
+
+        std::vector<KeyColumn> key_columns;
+        key_columns.reserve(keys.size());
+        for (const auto& key : keys) {
+            if (IsSortable(key.column)) {
+                key_columns.push_back(ExtractKey(rows, key));
+            }
+        }
+
+        if (key_columns.empty() || rows.size() < 2 || limit == 0) {
+            return;
+        }
+
+        // Key arrays are indexed by the trade index, rows hold trade indices
+        const auto less = [&key_columns](const uint32_t lhs, const uint32_t rhs) {
+            for (const auto& key : key_columns) {
+                int compare = 0;
+                switch (key.type) {
+                    case KeyType::Integer:
+                        compare = (key.integers[lhs] > key.integers[rhs]) -
+                                  (key.integers[lhs] < key.integers[rhs]);
+                        break;
+                    case KeyType::Double:
+                        compare = (key.doubles[lhs] > key.doubles[rhs]) -
+                                  (key.doubles[lhs] < key.doubles[rhs]);
+                        break;
+                    case KeyType::String:
+                        compare = key.strings[lhs].compare(key.strings[rhs]);
+                        break;
+                }
+                if (compare != 0) {
+                    return key.descending ? compare > 0 : compare < 0;
+                }
+            }
+            return lhs < rhs;
+        };
+
+        const auto middle = rows.begin() + static_cast<std::ptrdiff_t>(limit);
+
+        if (limit * PARTIAL_SELECTION_RATIO < rows.size()) {
+            // Top-K: only the window is ever ordered
+            if (limit <= HEAP_SELECTION_LIMIT) {
+                std::partial_sort(rows.begin(), middle, rows.end(), less);
+            } else {
+                std::nth_element(rows.begin(), middle - 1, rows.end(), less);
+                std::sort(rows.begin(), middle, less);
+            }
+        } else if (key_columns.front().type == KeyType::Integer &&
+                   rows.size() >= RADIX_SORT_THRESHOLD) {
+            // Stable LSD radix on the leading integer key keeps the fetch order for ties, same as
+            // the comparator; runs of equal leading keys are then ordered by the remaining keys
+            assert(std::is_sorted(rows.begin(), rows.end()));
+            RadixSort(rows, key_columns.front());
+
+            if (key_columns.size() > 1) {
+                const auto& leading = key_columns.front().integers;
+                auto        run     = rows.begin();
+                while (run != rows.end()) {
+                    const auto run_end = std::find_if(run, rows.end(), [&](const uint32_t row) {
+                        return leading[row] != leading[*run];
+                    });
+                    if (run_end - run > 1) {
+                        std::sort(run, run_end, less);
+                    }
+                    run = run_end;
+                }
+            }
+        } else {
+            std::sort(rows.begin(), rows.end(), less);
+        }
+    }
+
+    RowSorter::KeyColumn RowSorter::ExtractKey(const std::vector<uint32_t>& rows,
+                                               const SortKey&               key) const {
+        KeyColumn key_column;
+        key_column.descending = key.descending;
+
+        const ColumnId column = ParseColumnId(key.column);
+        switch (column) {
+            case ColumnId::Order:
+            case ColumnId::Login:
+            case ColumnId::OpenTime:
+                key_column.type = KeyType::Integer;
+                key_column.integers.resize(_trades.size());
+                break;
+            case ColumnId::Volume:
+            case ColumnId::OpenPrice:
+            case ColumnId::Sl:
+            case ColumnId::Tp:
+            case ColumnId::Storage:
+            case ColumnId::Profit:
+                key_column.type = KeyType::Double;
+                key_column.doubles.resize(_trades.size());
+                break;
+            default:
+                key_column.type = KeyType::String;
+                key_column.strings.resize(_trades.size());
+                break;
+        }
+
+        for (const uint32_t row : rows) {
+            const ReportTradeRecord& trade = _trades[row];
+            switch (column) {
+                case ColumnId::Order: key_column.integers[row] = trade.order; break;
+                case ColumnId::Login: key_column.integers[row] = trade.login; break;
+                case ColumnId::OpenTime: key_column.integers[row] = trade.open_time; break;
+                case ColumnId::Volume: key_column.doubles[row] = trade.volume; break;
+                case ColumnId::OpenPrice: key_column.doubles[row] = trade.open_price; break;
+                case ColumnId::Sl: key_column.doubles[row] = trade.sl; break;
+                case ColumnId::Tp: key_column.doubles[row] = trade.tp; break;
+                case ColumnId::Storage: key_column.doubles[row] = trade.storage; break;
+                case ColumnId::Profit: key_column.doubles[row] = trade.profit; break;
+                case ColumnId::Symbol: key_column.strings[row] = trade.symbol; break;
+                case ColumnId::Comment: key_column.strings[row] = trade.comment; break;
+                case ColumnId::Name:
+                    key_column.strings[row] = _account_index.Find(trade.login).name;
+                    break;
+                case ColumnId::Group:
+                    key_column.strings[row] = _account_index.Find(trade.login).group;
+                    break;
+                case ColumnId::Currency:
+                    key_column.strings[row] = _group_index.GetCurrency(
+                        _group_index.GetCurrencyId(_account_index.Find(trade.login).group));
+                    break;
+                case ColumnId::Type:
+                    key_column.strings[row] = GetCommandName(static_cast<int>(trade.cmd));
+                    break;
+                case ColumnId::Unknown: break;
+            }
+        }
+
+        // Money keys order by the converted value, as displayed
+        if (IsMoneyColumn(column) && _conversion != nullptr && !_conversion->IsIdentity()) {
+            for (const uint32_t row : rows) {
+                const ReportTradeRecord& trade       = _trades[row];
+                const CurrencyId         currency_id =
+                    _group_index.GetCurrencyId(_account_index.Find(trade.login).group);
+                key_column.doubles[row] *= _conversion->GetRate(currency_id, trade.cmd);
+            }
+        }
+
+        return key_column;
+    }
+
+    void RowSorter::RadixSort(std::vector<uint32_t>& rows, const KeyColumn& key) {
+        struct Entry {
+            uint64_t key;
+            uint32_t row;
+        };
+
+        std::vector<Entry> entries(rows.size());
+        std::vector<Entry> buffer(rows.size());
+
+        uint64_t all_or  = 0;
+        uint64_t all_and = ~uint64_t{0};
+        for (size_t i = 0; i < rows.size(); ++i) {
+            entries[i] = {ToRadixKey(key.integers[rows[i]], key.descending), rows[i]};
+            all_or |= entries[i].key;
+            all_and &= entries[i].key;
+        }
+
+        for (int shift = 0; shift < 64; shift += 8) {
+            // Bytes equal across all keys do not change the order
+            if (((all_or ^ all_and) >> shift & 0xFF) == 0) {
+                continue;
+            }
+
+            std::array<size_t, 256> counts{};
+            for (const auto& entry : entries) {
+                ++counts[entry.key >> shift & 0xFF];
+            }
+
+            size_t offset = 0;
+            for (auto& count : counts) {
+                const size_t bucket = count;
+                count               = offset;
+                offset += bucket;
+            }
+
+            for (const auto& entry : entries) {
+                buffer[counts[entry.key >> shift & 0xFF]++] = entry;
+            }
+            entries.swap(buffer);
+        }
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i] = entries[i].row;
+        }
+    }
+} // namespace report
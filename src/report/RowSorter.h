@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AccountIndex.h"
+#include "CurrencyConversion.h"
+#include "GroupIndex.h"
+#include "ReportRequest.h"
+#include "ReportServerInterface.h"
+
+namespace report {
+    // Server-side ordering of the pending trades table by any declared column. Keys are
+    // extracted once into typed arrays; ties fall through to the next key and finally to the
+    // fetch order, so results are deterministic. Money keys are converted with the
+    // `conversion` rates, when given.
+    class RowSorter {
+    public:
+        RowSorter(const std::vector<ReportTradeRecord>& trades,
+                  const AccountIndex&                   account_index,
+                  const GroupIndex&                     group_index,
+                  const ConversionMatrix*               conversion = nullptr);
+
+        [[nodiscard]] static bool IsSortable(const std::string& column);
+
+        // Orders `rows` (indices into trades) by `keys`. Only the first `limit` positions are
+        // guaranteed to be ordered: small windows use partial selection, full sorts led by an
+        // integer key use an LSD radix sort. `rows` must come in ascending (fetch) order, as the
+        // pipeline builds them: ties keep that order without an extra pass over the indices.
+        void Sort(std::vector<uint32_t>& rows, const std::vector<SortKey>& keys, size_t limit) const;
+
+    private:
+        enum class KeyType { Integer, Double, String };
+
+        struct KeyColumn {
+            KeyType                       type       = KeyType::Integer;
+            bool                          descending = true;
+            std::vector<int64_t>          integers;
+            std::vector<double>           doubles;
+            std::vector<std::string_view> strings;
+        };
+
+        const std::vector<ReportTradeRecord>& _trades;
+        const AccountIndex&                   _account_index;
+        const GroupIndex&                     _group_index;
+        const ConversionMatrix*               _conversion;
+
+        [[nodiscard]] KeyColumn ExtractKey(const std::vector<uint32_t>& rows, const SortKey& key) const;
+
+        static void RadixSort(std::vector<uint32_t>& rows, const KeyColumn& key);
+    };
+} // namespace report
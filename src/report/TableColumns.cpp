@@ -0,0 +1,79 @@
+#include "TableColumns.h"
+
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+#include "utils/Utils.h"
+
+namespace report {
+    ColumnId ParseColumnId(const std::string_view column) {
+        for (const auto& definition : COLUMN_DEFINITIONS) {
+            if (definition.key == column) {
+                return definition.id;
+            }
+        }
+        return ColumnId::Unknown;
+    }
+
+    const SharedColumns& GetTableColumns() {
+        static const SharedColumns columns = [] {
+            // Shared by every report: must not live in the arena of the first one
+            const ast::ResourceScope heap(std::pmr::new_delete_resource());
+
+            FilterConfig search_filter;
+            search_filter.type = FilterType::Search;
+
+            // open_time filters on unix times, not on the formatted local time
+            FilterConfig date_time_filter;
+            date_time_filter.type           = FilterType::DateTime;
+            date_time_filter.is_return_unix = true;
+
+            TableBuilder table_builder("");
+            double       column_order = 0;
+            for (const auto& column : COLUMN_DEFINITIONS) {
+                table_builder.AddColumn({std::string(column.key),
+                                         std::string(column.language_token),
+                                         ++column_order,
+                                         column.id == ColumnId::OpenTime ? date_time_filter
+                                                                         : search_filter});
+            }
+            return std::move(table_builder).ShareColumns();
+        }();
+        return columns;
+    }
+
+    bool IsAccountColumn(const ColumnId column) {
+        return column == ColumnId::Name || column == ColumnId::Currency ||
+               column == ColumnId::Group;
+    }
+
+    bool IsMoneyColumn(const ColumnId column) {
+        switch (column) {
+            case ColumnId::OpenPrice:
+            case ColumnId::Sl:
+            case ColumnId::Tp:
+            case ColumnId::Storage:
+            case ColumnId::Profit:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool IsNumericColumn(const ColumnId column) {
+        switch (column) {
+            case ColumnId::Order:
+            case ColumnId::Login:
+            case ColumnId::OpenTime:
+            case ColumnId::Volume:
+            case ColumnId::OpenPrice:
+            case ColumnId::Sl:
+            case ColumnId::Tp:
+            case ColumnId::Storage:
+            case ColumnId::Profit:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::string_view GetCommandName(const int cmd) { return utils::ConvertCmdToString(cmd); }
+} // namespace report
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+
+struct SharedColumns;
+
+namespace report {
+    // Columns of the pending trades table, in display order
+    enum class ColumnId {
+        Order,
+        Login,
+        Name,
+        OpenTime,
+        Type,
+        Symbol,
+        Volume,
+        OpenPrice,
+        Sl,
+        Tp,
+        Storage,
+        Profit,
+        Comment,
+        Currency,
+        Group,
+        Unknown
+    };
+
+    struct ColumnDefinition {
+        ColumnId         id;
+        std::string_view key;
+        std::string_view language_token;
+    };
+
+    // Every column in display order, shared by the table UI and the CSV export
+    inline constexpr std::array<ColumnDefinition, 15> COLUMN_DEFINITIONS = {{
+        {ColumnId::Order, "order", "ORDER"},
+        {ColumnId::Login, "login", "LOGIN"},
+        {ColumnId::Name, "name", "NAME"},
+        {ColumnId::OpenTime, "open_time", "OPEN_TIME"},
+        {ColumnId::Type, "type", "TYPE"},
+        {ColumnId::Symbol, "symbol", "SYMBOL"},
+        {ColumnId::Volume, "volume", "VOLUME"},
+        {ColumnId::OpenPrice, "open_price", "OPEN_PRICE"},
+        {ColumnId::Sl, "sl", "S / L"},
+        {ColumnId::Tp, "tp", "T / P"},
+        {ColumnId::Storage, "storage", "SWAP"},
+        {ColumnId::Profit, "profit", "AMOUNT"},
+        {ColumnId::Comment, "comment", "COMMENT"},
+        {ColumnId::Currency, "currency", "CURRENCY"},
+        {ColumnId::Group, "group", "GROUP"},
+    }};
+
+    ColumnId ParseColumnId(std::string_view column);
+
+    // Table column descriptions with their filters, built once per process
+    const SharedColumns& GetTableColumns();
+
+    // Columns whose cells come from the trade's account (and its group)
+    bool IsAccountColumn(ColumnId column);
+
+    // Money columns, converted into the report's target currency (volume is in lots)
+    bool IsMoneyColumn(ColumnId column);
+
+    // Columns whose cells are numbers (order and login included)
+    bool IsNumericColumn(ColumnId column);
+
+    // Display name of a trade command, as in the `type` column
+    std::string_view GetCommandName(int cmd);
+} // namespace report
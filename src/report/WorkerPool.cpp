@@ -0,0 +1,221 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+
+namespace report {
+    namespace {
+        size_t ConfiguredWorkersCount() {
+            if (const char* value = std::getenv("PENDING_TRADES_WORKERS")) {
+                const long count = std::strtol(value, nullptr, 10);
+                if (count > 0) {
+                    return std::min(static_cast<size_t>(count), WorkerPool::MAX_WORKERS);
+                }
+            }
+            const size_t hardware_count = std::thread::hardware_concurrency();
+            return std::clamp<size_t>(hardware_count, 1, WorkerPool::MAX_WORKERS);
+        }
+    } // namespace
+
+    // Shared by the runners of one parallel call. Runners claim indices from `next`; a runner that
+    // starts after every index was claimed touches nothing but the job itself. The first task
+    // exception cancels the job: indices claimed afterwards are marked done without running, and
+    // the exception is rethrown on the calling thread once no task is left in flight.
+    struct WorkerPool::Job {
+        explicit Job(const size_t count, const size_t lookahead = SIZE_MAX)
+            : count(count), lookahead(lookahead), done(new std::atomic<bool>[count]) {
+            for (size_t i = 0; i < count; ++i) {
+                done[i] = false;
+            }
+        }
+
+        const size_t                         count;
+        const size_t                         lookahead; // indices produced ahead of the consumer
+        std::atomic<size_t>                  next{0};
+        std::unique_ptr<std::atomic<bool>[]> done;
+        size_t                               done_count = 0;
+        std::atomic<bool>                    is_cancelled{false};
+        std::exception_ptr                   error;        // first task exception, under mutex
+        size_t                               consumed = 0; // indices the consumer is done with
+        std::mutex                           mutex;
+        std::condition_variable              condition;
+        std::condition_variable              consumed_condition;
+
+        void Run(const std::function<void(size_t)>& task) {
+            for (size_t i = next++; i < count; i = next++) {
+                if (i >= lookahead) {
+                    // Bounds the results waiting for the consumer, whatever the workers count
+                    std::unique_lock lock(mutex);
+                    consumed_condition.wait(
+                        lock, [this, i] { return is_cancelled || i - consumed < lookahead; });
+                }
+
+                std::exception_ptr task_error;
+                if (!is_cancelled) {
+                    try {
+                        task(i);
+                    } catch (...) {
+                        task_error = std::current_exception();
+                    }
+                }
+
+                const std::lock_guard lock(mutex);
+                if (task_error && !error) {
+                    error        = task_error;
+                    is_cancelled = true;
+                    consumed_condition.notify_all();
+                }
+                done[i] = true;
+                ++done_count;
+                condition.notify_all();
+            }
+        }
+
+        // Stops the remaining tasks and waits for the ones in flight, so that nothing touches the
+        // caller's state after it returns. The calling thread claims what is left itself rather
+        // than waiting for queued runners to start.
+        void Cancel(const std::function<void(size_t)>& task) {
+            {
+                const std::lock_guard lock(mutex);
+                is_cancelled = true;
+                consumed_condition.notify_all();
+            }
+            Run(task);
+            WaitAll();
+        }
+
+        void RethrowError() {
+            const std::lock_guard lock(mutex);
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        void Wait(const size_t index) {
+            if (!done[index]) {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this, index] { return done[index].load(); });
+            }
+        }
+
+        // Frees a slot of the lookahead window
+        void SetConsumed(const size_t consumed_count) {
+            const std::lock_guard lock(mutex);
+            consumed = consumed_count;
+            consumed_condition.notify_all();
+        }
+
+        void WaitAll() {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this] { return done_count == count; });
+        }
+    };
+
+    WorkerPool& WorkerPool::Instance() {
+        static WorkerPool instance;
+        return instance;
+    }
+
+    WorkerPool::WorkerPool() : _workers_count(ConfiguredWorkersCount()) {}
+
+    void WorkerPool::ParallelFor(const size_t count, const std::function<void(size_t)>& task) {
+        if (_workers_count <= 1 || count <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        const auto job = std::make_shared<Job>(count);
+        Submit(std::min(count, _workers_count) - 1, [job, &task] { job->Run(task); });
+
+        job->Run(task);
+        job->WaitAll();
+        job->RethrowError();
+    }
+
+    void WorkerPool::OrderedFor(const size_t                       count,
+                                const std::function<void(size_t)>& produce,
+                                const std::function<void(size_t)>& consume) {
+        if (_workers_count <= 1 || count <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                produce(i);
+                consume(i);
+            }
+            return;
+        }
+
+        // Producers stay at most two chunks per worker ahead of the consumer, so the memory held
+        // by produced results does not grow with the input
+        const auto job = std::make_shared<Job>(count, 2 * _workers_count);
+        Submit(std::min(count, _workers_count), [job, &produce] { job->Run(produce); });
+
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                job->Wait(i);
+                job->RethrowError();
+                consume(i);
+                job->SetConsumed(i + 1);
+            }
+        } catch (...) {
+            // A failed produce or consume: producers still reference the caller's state
+            job->Cancel(produce);
+            throw;
+        }
+    }
+
+    void WorkerPool::Submit(const size_t count, const std::function<void()>& runner) {
+        {
+            const std::lock_guard lock(_mutex);
+            if (_threads.empty()) {
+                Start();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                _queue.push_back(runner);
+            }
+        }
+        _condition.notify_all();
+    }
+
+    void WorkerPool::Start() {
+        _is_stopping = false;
+        _threads.reserve(_workers_count);
+        for (size_t i = 0; i < _workers_count; ++i) {
+            _threads.emplace_back([this] { Run(); });
+        }
+    }
+
+    void WorkerPool::Stop() {
+        std::vector<std::thread> threads;
+        {
+            const std::lock_guard lock(_mutex);
+            _is_stopping = true;
+            threads.swap(_threads);
+        }
+        _condition.notify_all();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void WorkerPool::Run() {
+        while (true) {
+            std::function<void()> runner;
+            {
+                std::unique_lock lock(_mutex);
+                _condition.wait(lock, [this] { return _is_stopping || !_queue.empty(); });
+                if (_queue.empty()) {
+                    return;
+                }
+                runner = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            runner();
+        }
+    }
+} // namespace report
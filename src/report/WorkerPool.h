@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace report {
+    // Fixed process-wide pool of worker threads shared by concurrent reports. Sized from the
+    // PENDING_TRADES_WORKERS environment variable, or the hardware concurrency capped at
+    // MAX_WORKERS. With a single worker everything runs inline on the calling thread.
+    class WorkerPool {
+    public:
+        static constexpr size_t MAX_WORKERS = 16;
+
+        static WorkerPool& Instance();
+
+        ~WorkerPool() { Stop(); }
+
+        WorkerPool(const WorkerPool&)            = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        [[nodiscard]] size_t WorkersCount() const { return _workers_count; }
+
+        // Runs task(0..count-1) on the workers and the calling thread, returns once all are done.
+        // The first exception of a task skips the tasks not started yet and is rethrown here.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+        // Runs produce(0..count-1) on the workers. consume(i) is called on the calling thread in
+        // index order, as soon as produce(i) has finished. produce(i) waits until consume has
+        // passed i - 2 x workers, so unconsumed results stay bounded. An exception of either
+        // stops the remaining tasks and is rethrown here once the workers are off the caller's
+        // state.
+        void OrderedFor(size_t                             count,
+                        const std::function<void(size_t)>& produce,
+                        const std::function<void(size_t)>& consume);
+
+        // Joins the workers; they are restarted by the next parallel call
+        void Stop();
+
+    private:
+        WorkerPool();
+
+        struct Job;
+
+        size_t                            _workers_count = 1;
+        std::vector<std::thread>          _threads;
+        std::deque<std::function<void()>> _queue;
+        std::mutex                        _mutex;
+        std::condition_variable           _condition;
+        bool                              _is_stopping = false;
+
+        void Start();
+        void Submit(size_t count, const std::function<void()>& runner);
+        void Run();
+    };
+} // namespace report
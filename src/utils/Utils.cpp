@@ -1,83 +1,234 @@
 #include "Utils.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TRUNCATE_WITH_AVX 1
+#else
+#define TRUNCATE_WITH_AVX 0
+#endif
+
 namespace utils {
-    void CreateUI(const ast::Node&                    node,
-                  rapidjson::Value&                   response,
-                  rapidjson::Document::AllocatorType& allocator) {
-        // Content
-        Value node_object(kObjectType);
-        to_json(node, node_object, allocator);
+    namespace {
+        constexpr time_t SECONDS_PER_DAY = 86'400;
+
+        // Days since 1970-01-01 of a proleptic Gregorian date and back (H. Hinnant's algorithms)
+        int64_t DaysFromCivil(int64_t year, const unsigned month, const unsigned day) {
+            year -= month <= 2;
+            const int64_t  era = (year >= 0 ? year : year - 399) / 400;
+            const auto     yoe = static_cast<unsigned>(year - era * 400);
+            const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146'097 + static_cast<int64_t>(doe) - 719'468;
+        }
 
-        Value content_array(kArrayType);
-        content_array.PushBack(node_object, allocator);
+        void CivilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+            days += 719'468;
+            const int64_t  era = (days >= 0 ? days : days - 146'096) / 146'097;
+            const auto     doe = static_cast<unsigned>(days - era * 146'097);
+            const unsigned yoe = (doe - doe / 1460 + doe / 36'524 - doe / 146'096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp  = (5 * doy + 2) / 153;
+
+            day   = doy - (153 * mp + 2) / 5 + 1;
+            month = mp < 10 ? mp + 3 : mp - 9;
+            year  = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+        }
 
-        // Header
-        Value header_array(kArrayType);
+        // Local minus UTC seconds at `timestamp`, as seen by localtime_r
+        bool GetUtcOffset(const time_t timestamp, int64_t& offset) {
+            std::tm tm{};
+            if (localtime_r(&timestamp, &tm) == nullptr) {
+                return false;
+            }
 
-        {
-            Value space_object(kObjectType);
-            space_object.AddMember("type", "Space", allocator);
+            const int64_t local_seconds =
+                DaysFromCivil(tm.tm_year + 1900LL, tm.tm_mon + 1, tm.tm_mday) * SECONDS_PER_DAY +
+                tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+            offset = local_seconds - timestamp;
+            return true;
+        }
 
-            Value children(kArrayType);
+        // Per-thread offsets of recently seen UTC days. A day whose offset differs between its
+        // first and last second holds a DST switch (or a leap second) and takes the generic path.
+        bool GetCachedUtcOffset(const time_t timestamp, int64_t& offset) {
+            struct Entry {
+                int64_t day    = INT64_MIN;
+                int64_t offset = 0;
+                bool    stable = false;
+            };
+            thread_local std::array<Entry, 8> entries;
+
+            const int64_t day   = timestamp >= 0 ? timestamp / SECONDS_PER_DAY
+                                                 : (timestamp + 1) / SECONDS_PER_DAY - 1;
+            Entry&        entry = entries[static_cast<uint64_t>(day) % entries.size()];
+
+            if (entry.day != day) {
+                int64_t first_offset = 0;
+                int64_t last_offset  = 0;
+                const time_t first   = static_cast<time_t>(day * SECONDS_PER_DAY);
+                entry.day            = day;
+                entry.stable         = GetUtcOffset(first, first_offset) &&
+                               GetUtcOffset(first + SECONDS_PER_DAY - 1, last_offset) &&
+                               first_offset == last_offset;
+                entry.offset         = first_offset;
+            }
 
-            Value text_object(kObjectType);
-            text_object.AddMember("type", "#text", allocator);
+            offset = entry.offset;
+            return entry.stable;
+        }
 
-            Value props(kObjectType);
-            props.AddMember("value", "Pending Trades report", allocator);
+        // 10^0..10^22 are exact doubles, the same values std::pow returns
+        constexpr double POWERS_OF_TEN[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
 
-            text_object.AddMember("props", props, allocator);
-            children.PushBack(text_object, allocator);
+        double GetPowerOfTen(const int digits) {
+            return digits >= 0 && digits < static_cast<int>(std::size(POWERS_OF_TEN))
+                       ? POWERS_OF_TEN[digits]
+                       : std::pow(10.0, digits);
+        }
 
-            space_object.AddMember("children", children, allocator);
+#if TRUNCATE_WITH_AVX
+        // vroundpd towards zero, vmulpd and vdivpd round exactly like their scalar forms
+        __attribute__((target("avx"))) size_t TruncateDoublesAvx(const double* values,
+                                                                 const size_t  count,
+                                                                 const double  factor,
+                                                                 double*       out) {
+            const __m256d factors = _mm256_set1_pd(factor);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m256d scaled = _mm256_mul_pd(_mm256_loadu_pd(values + i), factors);
+                const __m256d truncated =
+                    _mm256_round_pd(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                _mm256_storeu_pd(out + i, _mm256_div_pd(truncated, factors));
+            }
+            return i;
+        }
 
-            header_array.PushBack(space_object, allocator);
+        __attribute__((target("avx"))) size_t MultiplyDoublesAvx(const double* values,
+                                                                  const double* factors,
+                                                                  const size_t  count,
+                                                                  double*       out) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                _mm256_storeu_pd(
+                    out + i,
+                    _mm256_mul_pd(_mm256_loadu_pd(values + i), _mm256_loadu_pd(factors + i)));
+            }
+            return i;
         }
+#endif
+
+        void WriteTwoDigits(char* out, const unsigned value) {
+            out[0] = static_cast<char>('0' + value / 10);
+            out[1] = static_cast<char>('0' + value % 10);
+        }
+
+        // Modal header and footer do not depend on the report: built once per process and
+        // copied into each response. Literal strings are kept by reference in both.
+        const Document& GetModalChrome() {
+            static const Document chrome = [] {
+                Document chrome;
+                chrome.SetObject();
+                auto& allocator = chrome.GetAllocator();
+
+                // Header
+                Value header_array(kArrayType);
+
+                {
+                    Value space_object(kObjectType);
+                    space_object.AddMember("type", "Space", allocator);
+
+                    Value children(kArrayType);
+
+                    Value text_object(kObjectType);
+                    text_object.AddMember("type", "#text", allocator);
+
+                    Value props(kObjectType);
+                    props.AddMember("value", "Pending Trades report", allocator);
+
+                    text_object.AddMember("props", props, allocator);
+                    children.PushBack(text_object, allocator);
+
+                    space_object.AddMember("children", children, allocator);
 
-        // Footer
-        Value footer_array(kArrayType);
+                    header_array.PushBack(space_object, allocator);
+                }
 
-        {
-            Value space_object(kObjectType);
-            space_object.AddMember("type", "Space", allocator);
+                // Footer
+                Value footer_array(kArrayType);
 
-            Value props_space(kObjectType);
-            props_space.AddMember("justifyContent", "space-between", allocator);
-            space_object.AddMember("props", props_space, allocator);
+                {
+                    Value space_object(kObjectType);
+                    space_object.AddMember("type", "Space", allocator);
 
-            Value children(kArrayType);
+                    Value props_space(kObjectType);
+                    props_space.AddMember("justifyContent", "space-between", allocator);
+                    space_object.AddMember("props", props_space, allocator);
 
-            Value btn_object(kObjectType);
-            btn_object.AddMember("type", "Button", allocator);
+                    Value children(kArrayType);
 
-            Value btn_props_object(kObjectType);
-            btn_props_object.AddMember("className", "form_action_button", allocator);
-            btn_props_object.AddMember("borderType", "danger", allocator);
-            btn_props_object.AddMember("buttonType", "outlined", allocator);
+                    Value btn_object(kObjectType);
+                    btn_object.AddMember("type", "Button", allocator);
 
-            btn_props_object.AddMember("onClick", "{\"action\":\"CloseModal\"}", allocator);
+                    Value btn_props_object(kObjectType);
+                    btn_props_object.AddMember("className", "form_action_button", allocator);
+                    btn_props_object.AddMember("borderType", "danger", allocator);
+                    btn_props_object.AddMember("buttonType", "outlined", allocator);
 
-            btn_object.AddMember("props", btn_props_object, allocator);
+                    btn_props_object.AddMember(
+                        "onClick", "{\"action\":\"CloseModal\"}", allocator);
 
-            Value btn_children(kArrayType);
+                    btn_object.AddMember("props", btn_props_object, allocator);
 
-            Value text_object(kObjectType);
-            text_object.AddMember("type", "#text", allocator);
+                    Value btn_children(kArrayType);
 
-            Value text_props_object(kObjectType);
-            text_props_object.AddMember("value", "Close", allocator);
+                    Value text_object(kObjectType);
+                    text_object.AddMember("type", "#text", allocator);
 
-            text_object.AddMember("props", text_props_object, allocator);
-            btn_children.PushBack(text_object, allocator);
+                    Value text_props_object(kObjectType);
+                    text_props_object.AddMember("value", "Close", allocator);
 
-            btn_object.AddMember("children", btn_children, allocator);
+                    text_object.AddMember("props", text_props_object, allocator);
+                    btn_children.PushBack(text_object, allocator);
 
-            children.PushBack(btn_object, allocator);
+                    btn_object.AddMember("children", btn_children, allocator);
 
-            space_object.AddMember("children", children, allocator);
+                    children.PushBack(btn_object, allocator);
 
-            footer_array.PushBack(space_object, allocator);
+                    space_object.AddMember("children", children, allocator);
+
+                    footer_array.PushBack(space_object, allocator);
+                }
+
+                chrome.AddMember("headerContent", header_array, allocator);
+                chrome.AddMember("footerContent", footer_array, allocator);
+                return chrome;
+            }();
+            return chrome;
         }
+    } // namespace
+
+    void CreateUI(const ast::Node&                    node,
+                  rapidjson::Value&                   response,
+                  rapidjson::Document::AllocatorType& allocator) {
+        // Content
+        Value node_object(kObjectType);
+        to_json(node, node_object, allocator);
+
+        Value content_array(kArrayType);
+        content_array.PushBack(node_object, allocator);
+
+        // Header and footer
+        const Document& chrome = GetModalChrome();
+        Value header_array(chrome["headerContent"], allocator);
+        Value footer_array(chrome["footerContent"], allocator);
 
         // Modal
         Value model_object(kObjectType);
@@ -103,51 +254,94 @@ namespace utils {
         return oss.str();
     }
 
+    size_t FormatTimestamp(const time_t timestamp, char* buffer) {
+        int64_t offset = 0;
+        if (GetCachedUtcOffset(timestamp, offset)) {
+            const int64_t local   = static_cast<int64_t>(timestamp) + offset;
+            const int64_t days    = local >= 0 ? local / SECONDS_PER_DAY
+                                               : (local + 1) / SECONDS_PER_DAY - 1;
+            const auto    seconds = static_cast<unsigned>(local - days * SECONDS_PER_DAY);
+
+            int64_t  year  = 0;
+            unsigned month = 0;
+            unsigned day   = 0;
+            CivilFromDays(days, year, month, day);
+
+            // put_time does not pad %Y, other widths go through the generic path
+            if (year >= 1000 && year <= 9999) {
+                const auto full_year = static_cast<unsigned>(year);
+                WriteTwoDigits(buffer, full_year / 100);
+                WriteTwoDigits(buffer + 2, full_year % 100);
+                buffer[4] = '.';
+                WriteTwoDigits(buffer + 5, month);
+                buffer[7] = '.';
+                WriteTwoDigits(buffer + 8, day);
+                buffer[10] = ' ';
+                WriteTwoDigits(buffer + 11, seconds / 3600);
+                buffer[13] = ':';
+                WriteTwoDigits(buffer + 14, seconds / 60 % 60);
+                buffer[16] = ':';
+                WriteTwoDigits(buffer + 17, seconds % 60);
+                return 19;
+            }
+        }
+
+        const std::string formatted = FormatTimestampToString(timestamp);
+        const size_t      length    = std::min(formatted.size(), TIMESTAMP_BUFFER_SIZE);
+        formatted.copy(buffer, length);
+        return length;
+    }
+
+    void FormatTimestamps(const time_t*        timestamps,
+                          const size_t         count,
+                          std::string&         arena,
+                          std::vector<size_t>& offsets) {
+        char buffer[TIMESTAMP_BUFFER_SIZE];
+
+        arena.reserve(arena.size() + count * 19);
+        offsets.reserve(offsets.size() + count);
+
+        for (size_t i = 0; i < count; ++i) {
+            arena.append(buffer, FormatTimestamp(timestamps[i], buffer));
+            offsets.push_back(arena.size());
+        }
+    }
+
     double TruncateDouble(const double& value, const int& digits) {
-        const double factor = std::pow(10.0, digits);
+        const double factor = GetPowerOfTen(digits);
         return std::trunc(value * factor) / factor;
     }
 
-    std::string GetGroupCurrencyByName(const std::vector<ReportGroupRecord>& group_vector,
-                                       const std::string&                    group_name) {
-        for (const auto& group : group_vector) {
-            if (group.group == group_name) {
-                return group.currency;
-            }
+    void TruncateDoubles(const double* values, const size_t count, const int digits, double* out) {
+        const double factor = GetPowerOfTen(digits);
+
+        size_t done = 0;
+#if TRUNCATE_WITH_AVX
+        static const bool has_avx = __builtin_cpu_supports("avx");
+        if (has_avx) {
+            done = TruncateDoublesAvx(values, count, factor, out);
+        }
+#endif
+
+        for (size_t i = done; i < count; ++i) {
+            out[i] = std::trunc(values[i] * factor) / factor;
         }
-        return "N/A"; // группа не найдена - валюта не определена
     }
 
-    std::string ConvertCmdToString(const int cmd) {
-        switch (cmd) {
-            case -1:
-                return "Nothing";
-            case 0:
-                return "Buy";
-            case 1:
-                return "Sell";
-            case 2:
-                return "Buy Limit";
-            case 3:
-                return "Sell Limit";
-            case 4:
-                return "Buy Stop";
-            case 5:
-                return "Sell Stop";
-            case 6:
-                return "Deposit";
-            case 7:
-                return "Credit In";
-            case 8:
-                return "Withdrawal";
-            case 9:
-                return "Credit Out";
-            case 10:
-                return "Buy Stop Limit";
-            case 11:
-                return "Sell Stop Limit";
-            default:
-                return "Unknown";
+    void MultiplyDoubles(const double* values,
+                         const double* factors,
+                         const size_t  count,
+                         double*       out) {
+        size_t done = 0;
+#if TRUNCATE_WITH_AVX
+        static const bool has_avx = __builtin_cpu_supports("avx");
+        if (has_avx) {
+            done = MultiplyDoublesAvx(values, factors, count, out);
+        }
+#endif
+
+        for (size_t i = done; i < count; ++i) {
+            out[i] = values[i] * factors[i];
         }
     }
-} // namespace utils
\ No newline at end of file
+} // namespace utils
@@ -4,7 +4,11 @@
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "ReportServerInterface.h"
 #include "ast/Ast.hpp"
@@ -20,10 +24,49 @@ namespace utils {
     std::string FormatTimestampToString(const time_t&      timestamp,
                                         const std::string& format = "%Y.%m.%d %H:%M:%S");
 
+    // Buffer size for FormatTimestamp; years 1000-9999 take exactly 19 characters
+    constexpr size_t TIMESTAMP_BUFFER_SIZE = 32;
+
+    // Local time as "YYYY.MM.DD HH:MM:SS", the output of FormatTimestampToString with the
+    // default format. The UTC offset is cached per day and the date is computed arithmetically.
+    // Writes an unterminated string into `buffer` and returns its length.
+    size_t FormatTimestamp(time_t timestamp, char* buffer);
+
+    // Batch form: appends every timestamp to `arena` and its end offset to `offsets`
+    void FormatTimestamps(const time_t*        timestamps,
+                          size_t               count,
+                          std::string&         arena,
+                          std::vector<size_t>& offsets);
+
     double TruncateDouble(const double& value, const int& digits);
 
-    std::string GetGroupCurrencyByName(const std::vector<ReportGroupRecord>& group_vector,
-                                       const std::string&                    group_name);
+    // Column form of TruncateDouble with bit-identical results; `out` may alias `values`.
+    // Uses AVX when the CPU has it, 4 values per step.
+    void TruncateDoubles(const double* values, size_t count, int digits, double* out);
+
+    // out[i] = values[i] * factors[i], bit-identical to the scalar product; `out` may alias
+    // `values`. Uses AVX when the CPU has it.
+    void MultiplyDoubles(const double* values, const double* factors, size_t count, double* out);
+
+    // Trade command names by ReportTradeCommand value, from Nothing (-1) to Sell Stop Limit (11).
+    // The views are null-terminated and static, safe to emit with rapidjson::StringRef.
+    inline constexpr std::string_view COMMAND_NAMES[] = {"Nothing",
+                                                         "Buy",
+                                                         "Sell",
+                                                         "Buy Limit",
+                                                         "Sell Limit",
+                                                         "Buy Stop",
+                                                         "Sell Stop",
+                                                         "Deposit",
+                                                         "Credit In",
+                                                         "Withdrawal",
+                                                         "Credit Out",
+                                                         "Buy Stop Limit",
+                                                         "Sell Stop Limit"};
 
-    std::string ConvertCmdToString(const int cmd);
+    constexpr std::string_view ConvertCmdToString(const int cmd) {
+        return cmd >= -1 && cmd < static_cast<int>(std::size(COMMAND_NAMES)) - 1
+                   ? COMMAND_NAMES[cmd + 1]
+                   : std::string_view("Unknown");
+    }
 } // namespace utils
\ No newline at end of file